@@ -0,0 +1,102 @@
+// Checks of the incremental Solver class; data/test.sh builds and runs it.
+// Each check prints "api <name>: ok" or what went wrong.
+
+#define MICROSAT_LIBRARY
+#include "../microsat.cpp"
+
+static int failures = 0;
+
+static void check(const char* name, bool ok, const char* what)
+{
+    printf("api %s: %s%s\n", name, ok ? "ok" : "FAILED, ", ok ? "" : what);
+    if (!ok) failures++;
+}
+
+static bool satisfies(Solver& s, const int* clauses)
+{                                                                     // Whether the model satisfies the 0-terminated clauses
+    for (const int* c = clauses; *c; c++)                             // (a list ending with an empty clause)
+    {
+        bool sat = false;
+        for (; *c; c++)
+            if (s.value(*c) == *c) sat = true;
+        if (!sat) return false;
+    }
+    return true;
+}
+
+static void addClauses(Solver& s, const int* clauses)
+{
+    for (const int* c = clauses; *c; c++)
+    {
+        int size = 0;
+        while (c[size]) size++;
+        s.add_clause(c, size);
+        c += size;
+    }
+}
+
+static void incremental()
+{                                                                     // Clauses added between solve calls
+    Solver s;
+    int first[] = { 1, 2, 0, -1, 3, 0, 0 };
+    addClauses(s, first);
+    check("add_clause", s.solve() == SAT && satisfies(s, first), "first formula not satisfied");
+    int lits[] = { -3 };
+    s.add_clause(lits, 1);
+    check("add_clause unit", s.solve() == SAT && s.value(3) == -3 && s.value(2) == 2, "unit -3 not respected");
+    int repeated[] = { 4, 4, -2, 4 };                                 // Repeated literals count once
+    s.add_clause(repeated, 4);
+    check("add_clause repeated", s.solve() == SAT && s.value(4) == 4, "clause 4 -2 not satisfied");
+    lits[0] = -4;
+    int last = s.add_clause(lits, 1);
+    check("add_clause unsat", last == SAT && s.solve() == UNSAT && s.solve() == UNSAT, "formula should be unsatisfiable");
+}
+
+static void assumptions()
+{                                                                     // 1 -> 2 -> 3, 5 free: assuming 1, -3 and 5 fails on
+    Solver s;                                                         // 1 and -3 only
+    int clauses[] = { -1, 2, 0, -2, 3, 0, 4, 5, 0, 0 };
+    addClauses(s, clauses);
+    s.assume(1); s.assume(5); s.assume(-3);
+    check("assume unsat", s.solve() == UNSAT, "assumptions 1, 5, -3 should fail");
+    check("failed core", s.failed(1) && s.failed(-3) && !s.failed(5), "core should be 1 and -3");
+    check("assume cleared", s.solve() == SAT && satisfies(s, clauses), "assumptions should hold for one call");
+    s.assume(1); s.assume(-5);
+    check("assume sat", s.solve() == SAT && s.value(1) == 1 && s.value(3) == 3 && s.value(5) == -5 && s.value(4) == 4,
+          "model should follow the assumptions");
+}
+
+static void limits()
+{                                                                     // Pigeonhole 7 into 6 needs well over 100 conflicts:
+    Solver s;                                                         // the first call stops, the next ones resume
+    enum { PIGEONS = 7, HOLES = 6 };
+    for (int p = 0; p < PIGEONS; p++)
+    {
+        int lits[HOLES];
+        for (int h = 0; h < HOLES; h++) lits[h] = p * HOLES + h + 1;
+        s.add_clause(lits, HOLES);                                    // Every pigeon in a hole
+    }
+    for (int h = 0; h < HOLES; h++)
+        for (int p = 0; p < PIGEONS; p++)
+            for (int q = p + 1; q < PIGEONS; q++)
+            {
+                int lits[2] = { -(p * HOLES + h + 1), -(q * HOLES + h + 1) };
+                s.add_clause(lits, 2);                                // No two pigeons share a hole
+            }
+    s.set_limits(100, 0, 0, 0);
+    int result = s.solve();
+    check("limit unknown", result == UNKNOWN && s.core()->nConflicts == 100, "first call should stop at 100 conflicts");
+    int calls = 1;
+    while ((result = s.solve()) == UNKNOWN && calls < 1000) calls++;
+    check("limit resumed", result == UNSAT, "resumed calls should refute the formula");
+    s.set_limits(0, 0, 0, 0);
+    check("limit final", s.solve() == UNSAT, "a refuted formula stays refuted");
+}
+
+int main()
+{
+    incremental();
+    assumptions();
+    limits();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+# Benchmark and regression harness for microsat (Python 3 standard library only).
+#
+# Builds ../microsat.cpp and the reference ../origin_microsat.c, generates a corpus
+# (random 3-SAT at the phase transition, pigeonhole, graph colouring, and with
+# --sched exam timetabling, whose clauses are long) next to the aim instances of
+# this directory, and runs every instance with a timeout.  For each instance it
+# reports wall time, conflicts/s, propagations/s and peak RSS, the speedup over
+# the reference build, and PAR-2 scores over the corpus.
+#
+#   python3 bench.py [--timeout S] [--runs R] [--save FILE] [--baseline FILE]
+#
+# --save stores the results as a baseline; --baseline compares against one and
+# exits with status 1 when the new build is slower by more than --tolerance with
+# statistical significance (one-sided paired t-test on log run times at 95%), or
+# when a solver gives a wrong answer.  --scaling 1 2 4 instead runs microsat with
+# --threads 1, 2 and 4 (add e.g. --args '--cube 8' for cube-and-conquer) and
+# reports the speedup of each thread count over the first.  --widths runs microsat
+# with 16-bit literals (picked from the header when there are at most 32767
+# variables) and with --wide-lits, and reports both times, the speedup and the
+# bytes of clause database each width used.
+
+import argparse, json, math, os, random, re, statistics, subprocess, sys, threading, time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+T95 = [6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,     # One-sided 95% quantiles of
+       1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,     # Student's t, df = 1..30
+       1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697]
+
+
+def write_cnf(path, nvars, clauses):
+    with open(path, "w") as f:
+        f.write("p cnf %d %d\n" % (nvars, len(clauses)))
+        for c in clauses:
+            f.write(" ".join(map(str, c)) + " 0\n")
+
+
+def random3(n, seed):
+    rng = random.Random(seed)                                    # Uniform random 3-SAT at ratio 4.26
+    return n, [[v if rng.random() < 0.5 else -v for v in rng.sample(range(1, n + 1), 3)]
+               for _ in range(round(4.26 * n))]
+
+
+def pigeonhole(n):
+    var = lambda p, h: p * n + h + 1                             # n+1 pigeons in n holes (UNSAT)
+    clauses = [[var(p, h) for h in range(n)] for p in range(n + 1)]
+    clauses += [[-var(p, h), -var(q, h)] for h in range(n) for p in range(n + 1) for q in range(p)]
+    return (n + 1) * n, clauses
+
+
+def colouring(n, seed, k=3, density=2.3):
+    rng = random.Random(seed)                                    # k-colouring of a random graph near the threshold
+    var = lambda v, c: v * k + c + 1
+    edges = set()
+    while len(edges) < round(density * n):
+        a, b = rng.sample(range(n), 2)
+        edges.add((min(a, b), max(a, b)))
+    clauses = [[var(v, c) for c in range(k)] for v in range(n)]
+    clauses += [[-var(v, c), -var(v, d)] for v in range(n) for c in range(k) for d in range(c)]
+    clauses += [[-var(a, c), -var(b, c)] for a, b in sorted(edges) for c in range(k)]
+    return n * k, clauses
+
+
+def timetable(n, seed, slots=24, density=42):
+    return colouring(n, seed, slots, density)                    # Exams in slots, clashing exams apart: long
+                                                                 # at-least-one-slot clauses and their lemmas
+
+
+def corpus(args):
+    instances = []                                               # (name, path, expected answer or None)
+    def generate(name, formula, expected=None):
+        path = os.path.join(args.workdir, name + ".cnf")
+        if not os.path.exists(path):
+            write_cnf(path, *formula())
+        instances.append((name, path, expected))
+    for n in args.sizes:
+        for seed in range(args.seeds):
+            generate("rand3-%d-%d" % (n, seed), lambda: random3(n, seed))
+    for n in args.php:
+        generate("php-%d" % n, lambda: pigeonhole(n), "UNSATISFIABLE")
+    for n in args.colour:
+        for seed in range(args.seeds):
+            generate("col3-%d-%d" % (n, seed), lambda: colouring(n, seed))
+    for n in args.sched:
+        for seed in range(args.seeds):
+            generate("sched-%d-%d" % (n, seed), lambda: timetable(n, seed))
+    for name in sorted(os.listdir(HERE)):
+        if name.startswith("aim-") and name.endswith(".cnf"):   # The aim instances carry their answer in their name
+            instances.append((name[:-4], os.path.join(HERE, name), "UNSATISFIABLE" if "-no-" in name else "SATISFIABLE"))
+    for path in args.corpus:
+        files = [os.path.join(path, f) for f in sorted(os.listdir(path)) if f.endswith(".cnf")] if os.path.isdir(path) else [path]
+        instances += [(os.path.basename(f)[:-4], f, None) for f in files]
+    return instances
+
+
+def peak_rss(pid, done, peak):
+    while not done.is_set():                                     # VmHWM is the high-water mark of the solver's own
+        try:                                                     # address space (ru_maxrss would include the
+            with open("/proc/%d/status" % pid) as f:             # interpreter it was spawned from); it only grows,
+                for line in f:                                   # so polling misses at most the last 10 ms
+                    if line.startswith("VmHWM:"):
+                        peak[0] = max(peak[0], int(line.split()[1]))
+        except OSError:
+            return
+        done.wait(0.01)
+
+
+def run(cmd, timeout):
+    start = time.perf_counter()                                  # Wall time, output and peak RSS (KB) of one run
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    done, peak = threading.Event(), [0]
+    poller = threading.Thread(target=peak_rss, args=(proc.pid, done, peak))
+    poller.start()
+    try:
+        out = proc.communicate(timeout=timeout)[0].decode(errors="replace")
+        killed = False
+    except subprocess.TimeoutExpired:
+        proc.kill()
+        out, killed = proc.communicate()[0].decode(errors="replace"), True
+    wall = time.perf_counter() - start
+    done.set()
+    poller.join()
+    answer = re.search(r"^s (\w+)", out, re.M)
+    conflicts = re.search(r"conflicts: (\d+)", out)
+    props = re.search(r"propagations: (\d+)", out)
+    mem = re.search(r"mem: (\d+)", out)
+    return {"status": "TIMEOUT" if killed or not answer else answer.group(1), "time": wall,
+            "conflicts": int(conflicts.group(1)) if conflicts else None,
+            "props": int(props.group(1)) if props else None, "rss": peak[0],
+            "mem": int(mem.group(1)) if mem else None}
+
+
+def measure(cmd, path, args):
+    runs = [run(cmd + [path], args.timeout) for _ in range(args.runs)]
+    result = dict(runs[0])
+    result["time"] = statistics.median(r["time"] for r in runs)  # The median damps outliers between runs
+    result["rss"] = max(r["rss"] for r in runs)
+    if any(r["status"] == "TIMEOUT" for r in runs):
+        result["status"] = "TIMEOUT"
+    return result
+
+
+def par2(results, timeout):
+    scores = [r["time"] if r["status"] != "TIMEOUT" else 2 * timeout for r in results]
+    return sum(scores) / len(scores) if scores else 0.0
+
+
+def slower(new, old, tolerance):
+    pairs = [(n["time"], o["time"]) for n, o in zip(new, old)    # Paired one-sided t-test on log(new/old) over
+             if n["status"] != "TIMEOUT" and o["status"] != "TIMEOUT" and min(n["time"], o["time"]) >= 0.05]
+    if len(pairs) < 3:                                           # instances both solved in measurable time
+        return False, 1.0, 0.0
+    d = [math.log(a / b) for a, b in pairs]
+    mean, sd = statistics.mean(d), statistics.stdev(d)
+    t = mean / (sd / math.sqrt(len(d))) if sd > 0 else (math.inf if mean > 0 else 0.0)
+    quantile = T95[len(d) - 2] if len(d) - 1 <= len(T95) else 1.645
+    return mean > math.log(1 + tolerance) and t > quantile, math.exp(mean), t
+
+
+def scaling(microsat, instances, args):
+    counts = args.scaling
+    print("%-22s %-15s" % ("instance", "result") + "".join("%9s" % ("t%d[s]" % n) for n in counts) +
+          "".join("%8s" % ("x%d" % n) for n in counts[1:]))
+    columns, failed = [[] for _ in counts], False
+    for name, path, expected in instances:
+        runs = [measure([microsat] + args.args.split() + ["--threads", str(n)], path, args) for n in counts]
+        answers = {r["status"] for r in runs if r["status"] != "TIMEOUT"}
+        wrong = len(answers) > 1 or bool(expected and answers and answers != {expected})
+        failed |= wrong
+        solved = lambda r: r["status"] != "TIMEOUT"
+        print("%-22s %-15s" % (name, "/".join(sorted(answers)) or "TIMEOUT") +
+              "".join("%9.3f" % r["time"] if solved(r) else "%9s" % "-" for r in runs) +
+              "".join("%7.2fx" % (runs[0]["time"] / r["time"]) if solved(r) and solved(runs[0]) else "%8s" % "-"
+                      for r in runs[1:]) + ("  WRONG ANSWER" if wrong else ""))
+        sys.stdout.flush()
+        for column, r in zip(columns, runs):
+            column.append(r)
+    for n, column in zip(counts, columns):
+        print("PAR-2 %d threads: %.3f s" % (n, par2(column, args.timeout)))
+    if failed:
+        print("FAILED")
+    return 1 if failed else 0
+
+
+def widths(microsat, instances, args):
+    print("%-22s %-15s %9s %9s %8s %9s %9s %s" %
+          ("instance", "result", "t16[s]", "t32[s]", "x16", "db16[KB]", "db32[KB]", "search"))
+    columns, failed = [[], []], False
+    for name, path, expected in instances:
+        narrow = measure([microsat] + args.args.split(), path, args)
+        wide = measure([microsat] + args.args.split() + ["--wide-lits"], path, args)
+        answers = {r["status"] for r in (narrow, wide) if r["status"] != "TIMEOUT"}
+        wrong = len(answers) > 1 or bool(expected and answers and answers != {expected})
+        failed |= wrong
+        solved = narrow["status"] != "TIMEOUT" and wide["status"] != "TIMEOUT"
+        kb = lambda r, size: "%9.1f" % (r["mem"] * size / 1024.0) if r["mem"] is not None else "%9s" % "-"
+        same = (narrow["conflicts"], narrow["props"]) == (wide["conflicts"], wide["props"])
+        print("%-22s %-15s %9.3f %9.3f %8s %s %s %s%s" % (     # mem counts DB entries: 2 and 4 bytes each
+            name, "/".join(sorted(answers)) or "TIMEOUT", narrow["time"], wide["time"],
+            "%.2fx" % (wide["time"] / narrow["time"]) if solved else "-", kb(narrow, 2), kb(wide, 4),
+            "same" if same else "differs", "  WRONG ANSWER" if wrong else ""))
+        sys.stdout.flush()
+        columns[0].append(narrow)
+        columns[1].append(wide)
+    print("PAR-2 16-bit: %.3f s, 32-bit: %.3f s" % (par2(columns[0], args.timeout), par2(columns[1], args.timeout)))
+    if failed:
+        print("FAILED")
+    return 1 if failed else 0
+
+
+def build(args):
+    os.makedirs(args.workdir, exist_ok=True)
+    microsat = args.solver or os.path.join(args.workdir, "microsat")
+    if not args.solver:
+        subprocess.check_call(["g++", os.path.join(HERE, "..", "microsat.cpp"), "-O2", "-pthread", "-o", microsat])
+    origin = None
+    if not args.no_origin:
+        origin = os.path.join(args.workdir, "origin_microsat")
+        subprocess.check_call(["gcc", "-x", "c", os.path.join(HERE, "..", "origin_microsat.c"), "-O2", "-o", origin])
+    return microsat, origin
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--timeout", type=float, default=60.0, help="seconds per run (PAR-2 counts 2x for a timeout)")
+    parser.add_argument("--runs", type=int, default=3, help="runs per instance (the median time is used)")
+    parser.add_argument("--sizes", type=int, nargs="*", default=[100, 150, 175, 200], help="random 3-SAT sizes")
+    parser.add_argument("--seeds", type=int, default=3, help="generated instances per size")
+    parser.add_argument("--php", type=int, nargs="*", default=[6, 7], help="pigeonhole sizes")
+    parser.add_argument("--colour", type=int, nargs="*", default=[100, 150], help="3-colouring graph sizes")
+    parser.add_argument("--sched", type=int, nargs="*", default=[], help="timetabling sizes (200 takes seconds)")
+    parser.add_argument("--corpus", nargs="*", default=[], help="extra CNF files or directories")
+    parser.add_argument("--quick", action="store_true", help="small corpus, one run each")
+    parser.add_argument("--solver", help="microsat binary to test (default: build ../microsat.cpp)")
+    parser.add_argument("--args", default="", help="extra solver options, e.g. '--threads 4'")
+    parser.add_argument("--no-origin", action="store_true", help="skip the origin_microsat.c reference")
+    parser.add_argument("--workdir", default=os.path.join(os.environ.get("TMPDIR", "/tmp"), "microsat-bench"))
+    parser.add_argument("--save", help="store the results as a baseline")
+    parser.add_argument("--baseline", help="compare against a baseline stored with --save")
+    parser.add_argument("--tolerance", type=float, default=0.05, help="slowdown accepted before failing")
+    parser.add_argument("--scaling", type=int, nargs="*", default=[], help="thread counts to compare, e.g. 1 2 4")
+    parser.add_argument("--widths", action="store_true", help="compare 16-bit literals with --wide-lits")
+    args = parser.parse_args()
+    if args.quick:
+        args.sizes, args.seeds, args.php, args.colour, args.runs = [100, 150], 2, [6], [100], 1
+
+    if args.scaling or args.widths:
+        args.no_origin = True                                    # Only microsat runs, once per thread count or width
+    microsat, origin = build(args)
+    if args.scaling:
+        return scaling(microsat, corpus(args), args)
+    if args.widths:
+        return widths(microsat, corpus(args), args)
+    baseline = json.load(open(args.baseline)) if args.baseline else {}
+    instances = corpus(args)
+    rows, failed = [], False
+    print("%-22s %-15s %9s %11s %11s %8s %9s %8s %9s" %
+          ("instance", "result", "time[s]", "conflicts/s", "props/s", "rss[MB]", "origin[s]", "speedup", "vs base"))
+    for name, path, expected in instances:
+        new = measure([microsat] + args.args.split(), path, args)
+        ref = measure([origin], path, args) if origin else None
+        answers = {r["status"] for r in (new, ref) if r and r["status"] != "TIMEOUT"}
+        wrong = len(answers) > 1 or bool(expected and answers and answers != {expected})
+        failed |= wrong
+        rate = lambda n: "%11.0f" % (n / new["time"]) if n is not None and new["status"] != "TIMEOUT" else "%11s" % "-"
+        old = baseline.get("results", {}).get(name)
+        print("%-22s %-15s %9.3f %s %s %8s %9s %8s %9s%s" % (
+            name, new["status"], new["time"], rate(new["conflicts"]), rate(new["props"]),
+            "%.1f" % (new["rss"] / 1024.0) if new["rss"] else "-",                # Runs shorter than one poll have no RSS
+            "%9.3f" % ref["time"] if ref else "-",
+            "%.2fx" % (ref["time"] / new["time"]) if ref and new["status"] != "TIMEOUT" else "-",
+            "%.2fx" % (old["time"] / new["time"]) if old and new["status"] != "TIMEOUT" else "-",
+            "  WRONG ANSWER" if wrong else ""))
+        sys.stdout.flush()
+        rows.append((name, new, ref, old))
+
+    news = [r[1] for r in rows]
+    print("PAR-2 microsat: %.3f s" % par2(news, args.timeout))
+    if origin:
+        print("PAR-2 origin:   %.3f s" % par2([r[2] for r in rows], args.timeout))
+    if baseline:
+        pairs = [(r[1], r[3]) for r in rows if r[3]]
+        print("PAR-2 baseline: %.3f s (same %d instances: %.3f s now)" % (
+            par2([o for _, o in pairs], baseline.get("timeout", args.timeout)), len(pairs), par2([n for n, _ in pairs], args.timeout)))
+        regression, ratio, t = slower([n for n, _ in pairs], [o for _, o in pairs], args.tolerance)
+        print("time vs baseline: %.3fx (geometric mean), t = %.2f%s" % (ratio, t, "  REGRESSION" if regression else ""))
+        lost = [r[0] for r in rows if r[3] and r[1]["status"] == "TIMEOUT" and r[3]["status"] != "TIMEOUT"]
+        if lost:
+            print("timeouts on instances solved by the baseline: " + " ".join(lost))
+        failed |= regression or bool(lost)
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump({"timeout": args.timeout, "args": args.args, "results": {r[0]: r[1] for r in rows}}, f, indent=1)
+    if failed:
+        print("FAILED")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,14 @@
+# Parse throughput of the mmap parser against the getc/fscanf parser and a binary cache.
+# Usage: bash bench_parse.sh [VARS] [CLAUSES]   (default: 1000000 vars, 4200000 clauses)
+VARS=${1:-1000000}
+CLAUSES=${2:-4200000}
+FILE=bench_parse.cnf
+g++ ../microsat.cpp -O2 -pthread -o microsat
+awk -v n=$VARS -v m=$CLAUSES 'BEGIN { srand(1); print "c random 3-SAT for parse benchmarking"; print "p cnf", n, m;
+  for (i = 0; i < m; i++) { for (j = 0; j < 3; j++) { v = int(rand() * n) + 1; printf "%d ", (rand() < 0.5 ? -v : v) } print 0 } }' > $FILE
+cat $FILE > /dev/null                                   # Warm the page cache so both parsers read from memory
+./microsat --parse-only --legacy-parse $FILE
+./microsat --parse-only $FILE
+./microsat --write-cache $FILE.bin $FILE
+./microsat --parse-only $FILE.bin
+rm -f $FILE $FILE.bin
@@ -0,0 +1,30 @@
+# Overhead of proof logging: solve time without --proof, with the proof written to a file and to /dev/null.
+# Usage: bash bench_proof.sh [VARS] [INSTANCES] [RUNS]   (default: 5 random 3-SAT instances of 200 vars, best of 3 runs)
+VARS=${1:-200}
+INSTANCES=${2:-5}
+RUNS=${3:-3}
+CLAUSES=$((VARS * 43 / 10))
+g++ ../microsat.cpp -O2 -pthread -o microsat
+best () {                                               # Fastest of RUNS solves of $1 with the options in $2
+  b=
+  for r in $(seq $RUNS); do
+    s=$(date +%s.%N); ./microsat $2 $1 > /dev/null; e=$(date +%s.%N)
+    b=$(echo "$s $e $b" | awk '{ t = $2 - $1; print ($3 == "" || t < $3) ? t : $3 }')
+  done
+  echo $b
+}
+printf "%-22s %9s %9s %9s %9s\n" instance off file /dev/null MB
+for i in $(seq $INSTANCES); do
+  FILE=bench_proof_$i.cnf
+  awk -v n=$VARS -v m=$CLAUSES -v seed=$i 'BEGIN { srand(seed); print "p cnf", n, m;
+    for (i = 0; i < m; i++) { for (j = 0; j < 3; j++) { v = int(rand() * n) + 1; printf "%d ", (rand() < 0.5 ? -v : v) } print 0 } }' > $FILE
+  off=$(best $FILE "")
+  file=$(best $FILE "--proof $FILE.drat")
+  null=$(best $FILE "--proof /dev/null")
+  mb=$(du -m --apparent-size $FILE.drat | cut -f1)
+  printf "%-22s %9.3f %9.3f %9.3f %9s\n" $FILE $off $file $null $mb
+  echo "$off $file $null" >> bench_proof.times
+  rm -f $FILE $FILE.drat
+done
+awk '{ off += $1; file += $2; null += $3 } END { printf "overhead: %.1f%% (file), %.1f%% (/dev/null)\n", 100 * (file / off - 1), 100 * (null / off - 1) }' bench_proof.times
+rm -f bench_proof.times
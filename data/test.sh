@@ -1,7 +1,11 @@
-g++ ../microsat.cpp -O2 -o microsat
-./microsat aim-50-1_6-no-1.cnf >out
-./microsat aim-50-1_6-yes1-3.cnf >>out
-./microsat aim-50-6_0-yes1-2.cnf >>out
-./microsat aim-200-1_6-no-1.cnf >>out
-./microsat aim-200-1_6-yes1-3.cnf >>out
-diff out expected_out -s
\ No newline at end of file
+g++ ../microsat.cpp -O2 -pthread -o microsat
+TIMES='s/^\(c   [a-z]* *\)[0-9][0-9]*\.[0-9]* s  /\1/'              # Drop the pass times, which vary between machines
+./microsat aim-50-1_6-no-1.cnf | sed "$TIMES" >out
+./microsat aim-50-1_6-yes1-3.cnf | sed "$TIMES" >>out
+./microsat aim-50-6_0-yes1-2.cnf | sed "$TIMES" >>out
+./microsat aim-200-1_6-no-1.cnf | sed "$TIMES" >>out
+./microsat aim-200-1_6-yes1-3.cnf | sed "$TIMES" >>out
+g++ api_test.cpp -O2 -pthread -o api_test
+./api_test >>out
+rm -f api_test
+diff out expected_out -s
@@ -26,106 +26,666 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <atomic>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <signal.h>
 
-enum { END = -9, UNSAT = 0, SAT = 1, MARK = 2, IMPLIED = 6, NOT_IMPLIED = 5};
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(MICROSAT_LIBRARY)
+#include <immintrin.h>                                                // AVX2 and AVX-512 clause scans, picked at run time
+#define SIMD_SCAN                                                     // (by --simd, so not in a library build)
+#endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(p) __builtin_prefetch (p)
+#else
+#define PREFETCH(p)
+#endif
+
+#ifdef DB64
+typedef long long ref;                                                // Offsets into DB (and reasons): 64-bit build for
+#define REF_MAX LLONG_MAX                                             // clause databases beyond 2^31 ints
+#else
+typedef int ref;
+#define REF_MAX INT_MAX
+#endif
+
+#ifdef STATS
+#define STAT(x) x                                                     // Hot-path counters, compiled in with -DSTATS; without
+#else                                                                 // it they vanish and the search loop is unchanged (an
+#define STAT(x) do { } while (0)                                      // empty statement, also as the body of an else)
+#endif
+
+enum { INIT_MEM = 1 << 16 };                                          // Initial size of DB in entries; it doubles when full
+enum { CORE_LBD = 2, TIER2_LBD = 6 };                                 // Lemma tiers: core lemmas are kept forever, tier2 lemmas
+                                                                      // while used since the previous reduction, local ones
+                                                                      // compete on their usage stamp
+
+enum { SHARE_SLOTS = 1 << 12, SHARE_MAX = 16, SEEN_SIZE = 1 << 16 }; // Export ring slots per worker, longest shareable lemma,
+enum { IMPORTED = 1 << 30 };                                          // and entries of the duplicate filter; header flag of
+enum { IMPORT_INTERVAL = 1000 };                                      // imported lemmas not yet used in propagation; most
+                                                                      // conflicts between two imports
+enum { HIST_SIZE = 32 };                                              // Buckets of the lemma size and LBD histograms (the
+                                                                      // last one collects all larger values)
+enum { PROGRESS_CHECK = 1023 };                                       // Conflicts between two looks at the clock (mask)
+enum { DEADLINE_CHECK = 1023 };                                       // Iterations of solve between two looks at the deadline
+enum { VIVIFY_INTERVAL = 2000, VIVIFY_EFFORT = 3 };                   // Conflicts between two vivification rounds, and the
+enum { VIVIFIED = 1 << 29, REMOVED = 1 << 28 };                       // propagations of a round in % of those of the search;
+enum { LEMMA_FLAGS = IMPORTED | VIVIFIED | REMOVED };                 // header flags of lemmas tried by vivification and of
+                                                                      // lemmas replaced by a shorter one (reduceDB drops them)
+enum { WALK_INTERVAL = 5000, WALK_PROBS = 64 };                       // The n-th local search waits n * WALK_INTERVAL conflicts
+static const double WALK_CB = 2.06, WALK_EPS = 0.9;                   // after the previous one; ProbSAT picks a variable with
+                                                                      // weight (WALK_EPS + break)^-WALK_CB (tabulated up to
+                                                                      // WALK_PROBS breaks)
+static const double VAR_DECAY = 0.95, RESCALE = 1e100;                // EVSIDS: activities decay by 5% per conflict (the bump
+                                                                      // grows instead) and are scaled down beyond RESCALE
+enum { RESTART_EMA, RESTART_LUBY, RESTART_GEOMETRIC };                // Restart policies of focused mode (stable mode always
+                                                                      // follows the Luby sequence, with a longer unit)
+enum { SCAN_SCALAR = 6, FALS_PAD = 3, DB_PAD = 16 };                 // propagate scans clause[2..5] itself and the rest with
+                                                                      // a vector kernel (with --simd), which reads four bytes
+                                                                      // of fals per literal (hence FALS_PAD bytes past
+                                                                      // fals[nVars]) and whole vectors of up to 16 literals,
+                                                                      // past the terminator (hence DB_PAD entries past mem_max)
+enum { PROOF_BUFFER = 1 << 22 };                                      // Bytes of each of the two buffers of a DRAT proof
+enum { UNKNOWN = -2, ERROR = -1, UNSAT = 0, SAT = 1, MARK = 2, IMPLIED = 6, NOT_IMPLIED = 5};
+
+template <typename Lit>                                               // The solver is a template on the type of the literals
+static const int MAX_VAR = sizeof (Lit) < sizeof (int) ? SHRT_MAX : INT_MAX; // in DB: formulas of at most MAX_VAR<short>
+                                                                      // variables get 16-bit literals, the others int ones
+template <typename Lit>                                               // A clause in DB is a header of two ints (the LBD with
+static const int HEAD = 2 * sizeof (int) / sizeof (Lit);              // the flags, and the conflict of its last use) in HEAD
+enum { LBD_WORD = 2, STAMP_WORD = 1 };                                // entries, its literals and a 0; a ref points at its
+                                                                      // first literal, and the header ints are counted back
+template <typename Lit>                                               // from there
+static inline int header(const Lit* clause, int word)
+{                                                                     // Read an int of the header of a clause (with 16-bit
+    int value;                                                        // literals it spans two unaligned entries)
+    memcpy (&value, (const char*) clause - word * sizeof (int), sizeof (int));
+    return value;
+}
+
+template <typename Lit>
+static inline void setHeader(Lit* clause, int word, int value)
+{
+    memcpy ((char*) clause - word * sizeof (int), &value, sizeof (int));
+}
+
+struct watch
+{                                                                     // A watch of a clause on one of its first two literals
+    ref cref;                                                         // Offset of the clause in DB
+    int blocker;                                                      // and a cached literal of it
+};
+
+struct watchList
+{                                                                     // Contiguous array of the watches of one literal
+    struct watch* w;
+    int size, cap;
+};
+
+struct binList
+{                                                                     // Contiguous array of the literals implied by one literal
+    int* lits;
+    int size, cap;
+};
+
+struct schedule
+{                                                                     // The options of the restart and mode scheduler
+    int policy;                                                       // RESTART_EMA, RESTART_LUBY or RESTART_GEOMETRIC
+    int margin;                                                       // EMA: restart when the fast LBD average exceeds the
+                                                                      // slow one by margin %
+    int unit;                                                         // Luby: conflicts per unit of the sequence; geometric:
+    double factor;                                                    // first interval, multiplied by factor at each restart
+    int modeInterval;                                                 // Conflicts of the first focused and stable phases
+                                                                      // (0: focused mode only)
+    int stableUnit;                                                   // Luby unit of stable mode
+};
+
+static const struct schedule DEFAULT_SCHEDULE =                      // Restart when fast exceeds slow by 25% (or every 100
+    { RESTART_EMA, 125, 100, 1.5, 0, 1024 };                          // conflicts times the Luby sequence, or after 100, 150,
+                                                                      // 225, ... conflicts); no stable mode, which would
+                                                                      // restart after 1024 conflicts times the Luby sequence
+struct stats
+{                                                                     // Counters of the search, updated only with -DSTATS
+    long long decisions, watchVisits, clauseVisits, reductions, minimized;
+    double reduceTime;                                                // Seconds spent in reduceDB
+    long long lemmaSize[HIST_SIZE], lemmaLbd[HIST_SIZE];              // Learned clauses by size and by LBD
+};
+
+template <typename Lit>
 struct solver
 {
-    int *DB, nVars, nClauses, mem_used, mem_fixed, mem_max;
-    int maxLemmas, nLemmas, *buffer, nConflicts, *model;
-    int *reason, *falseStack, *fals, *first, *forced, *processed, *assigned;
+    Lit* DB;                                                          // The clauses (see HEAD)
+    int nVars, nClauses;
+    ref mem_used, mem_fixed, mem_max;
+    int maxLemmas, nLemmas, *buffer, nConflicts, *model, lastReduce;
+    long long nPropagations;                                          // Trail literals whose long watches were visited
+    bool reuse;                                                       // Keep the decisions a restart would take again
+    int chrono;                                                       // Backtrack one level when a backjump is longer (0: never)
+    int nReuses, nChrono;                                             // Restarts that kept part of the trail, chronological
+    long long reusedLits, chronoLits;                                 // backtracks, and the literals they kept on the trail
+    bool walk;                                                        // Run local search at restarts to set the phases
+    int nWalks, nextWalk, walkBest;                                   // Local searches so far, conflict of the next one, and
+    long long walkFlips;                                              // the fewest falsified clauses of the last one; flips
+    bool vivify;                                                      // Vivify the tier2 and core lemmas at restarts
+    bool probing;                                                     // propagate returns UNKNOWN at a conflict above the
+                                                                      // root instead of analyzing it
+    int nVivify, nextVivify;                                          // Rounds so far, and conflict of the next one
+    long long vivifyProps, vivified, vivifiedLits;                    // Propagations at the end of the previous round,
+    double vivifyTime;                                                // lemmas shortened, literals removed and seconds spent
+    ref *reason;
+    int *falseStack, *forced, *processed, *assigned;
+    unsigned char* fals;                                              // Per literal: 0, false (1), MARK, or IMPLIED/NOT_IMPLIED;
+                                                                      // one byte keeps more of it in cache during propagate
+    int *level, *trailLim, nLevels;                                   // Decision level of each variable, falseStack offset of
+                                                                      // the decision of each level, and the current level
+    int *touched, *minStack, *levelStamp;                             // Literals whose MARK analyze must reset, the frames of
+                                                                      // minimization, and the last conflict that saw each level
     int *next, *prev, head, fast, slow;
+    struct schedule schedule;                                         // When to restart and to switch modes
+    bool stable, focusEvsids;                                         // Stable mode, and the heuristic of focused mode
+    int nRestarts, restartSeq, lastRestart;                           // Restarts so far, the scheduled ones of this mode, and
+                                                                      // the conflict of the last one
+    int nSwitches, modeStart, nStableRestarts;                        // Mode switches, the conflict of the last one, and the
+    long long stableConflicts;                                        // restarts and conflicts of the past stable phases
+    bool evsids;                                                      // Decide by activity (EVSIDS) instead of move-to-front
+    double *activity, varInc;                                         // Activity of each variable and the current bump
+    int *heap, heapSize, *heapPos;                                    // Max-heap of variables by activity; position in it (-1: absent)
+    struct watchList* watches;                                        // Watch lists indexed by literal (-nVars..nVars)
+    struct binList* bins;                                             // Learned binary clauses as implication lists, and
+    struct binList* irrBins;                                          // input ones (read-only, may be shared), indexed likewise
+    bool sharedBins;                                                  // Whether irrBins belongs to another solver
+    int lemmaInc;                                                     // Growth of maxLemmas
+    std::atomic<int>* stop;                                           // Set by another thread to cancel solve (or NULL)
+    std::atomic<int>* interrupt;                                      // Set by the user (any thread or a signal handler) to
+                                                                      // make solve return UNKNOWN; never reset here (or NULL)
+    struct sharing* share;                                            // Lemma exchange with other workers (or NULL)
+    struct proof* proof;                                              // DRAT proof of the lemmas and deletions (or NULL)
+    int shareId, nExported, nImported, nImportUsed, nextImport;       // Index of this worker's ring and sharing statistics
+    unsigned *readPos;                                                // Next entry to import from each worker's ring
+    unsigned long long *seen;                                         // Hashes of shared lemmas (lossy duplicate filter)
+    int *assumptions, nAssumptions, assumed;                          // Literals decided first, and how many are known true
+    int failedAssumption;                                             // The assumption found false by the last solve (or 0)
+    int conflictLimit;                                                // solve returns UNKNOWN once nConflicts reaches it,
+    long long propagationLimit;                                       // nPropagations reaches it, mem_used exceeds memLimit
+    ref memLimit;                                                     // (0: none; DB then also grows at most to it), or
+    double deadline;                                                  // once wallTime () passes the deadline (0: none)
+    double progress, nextProgress, startTime;                         // Seconds between progress lines (0: none), the time
+    struct stats stats;                                               // of the next one and of the start; see STAT
+};
+
+struct shareSlot
+{                                                                     // One lemma in an export ring, guarded by a seqlock:
+    std::atomic<unsigned> seq;                                        // odd while written, 2*(entry+1) once complete
+    std::atomic<int> size, lbd, lits[SHARE_MAX];
+};
+
+struct shareRing
+{                                                                     // Lemmas exported by one worker (single producer);
+    std::atomic<unsigned> head;                                       // slow readers lose the entries that were overwritten
+    struct shareSlot slots[SHARE_SLOTS];
 };
 
-int* getMemory (struct solver* S, int mem_size)
+struct sharing
+{                                                                     // Shared by all portfolio workers
+    struct shareRing* rings;
+    int nWorkers, maxSize, maxLbd;                                    // Export lemmas with size <= maxSize and lbd <= maxLbd
+};
+
+struct proof
+{                                                                     // A binary DRAT proof: the search fills one buffer
+    int fd;                                                           // while a writer thread writes the other to the
+    unsigned char* buf[2];                                            // file or pipe fd
+    size_t cap, used, pending;                                        // Size of the buffers, bytes in the one being filled
+    int filling;                                                      // (buf[filling]) and bytes left to write of the other
+    bool closing, failed;
+    long long added, deleted, bytes;                                  // Lines and bytes of the proof so far
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;                                              // Signals pending and closing changes
+};
+
+#ifndef MICROSAT_LIBRARY
+static void* writeProof(void* arg)
+{                                                                     // The writer thread: write each handed over buffer
+    struct proof* F = (struct proof*) arg;
+    pthread_mutex_lock (&F->lock);
+    for (;;)
+    {
+        while (!F->pending && !F->closing) pthread_cond_wait (&F->cond, &F->lock);
+        if (!F->pending) break;                                       // Closing, and everything is written
+        unsigned char* data = F->buf[!F->filling];
+        size_t left = F->pending;
+        pthread_mutex_unlock (&F->lock);
+        while (left && !F->failed)
+        {
+            ssize_t n = write (F->fd, data, left);
+            if (n < 0) F->failed = true;                              // The search goes on; closeProof reports it
+            else data += n, left -= n;
+        }
+        pthread_mutex_lock (&F->lock);
+        F->pending = 0;
+        pthread_cond_broadcast (&F->cond);
+    }
+    pthread_mutex_unlock (&F->lock);
+    return NULL;
+}
+#endif
+
+static void flushProof(struct proof* F)
+{                                                                     // Hand the filled buffer over to the writer, after it
+    pthread_mutex_lock (&F->lock);                                    // has written the previous one
+    while (F->pending) pthread_cond_wait (&F->cond, &F->lock);
+    F->filling = !F->filling;
+    F->pending = F->used;
+    F->bytes += F->used;
+    F->used = 0;
+    pthread_cond_broadcast (&F->cond);
+    pthread_mutex_unlock (&F->lock);
+}
+
+template <typename Lit>
+static inline void proofLine(struct proof* F, int type, const Lit* lits, int size)
+{                                                                     // Append an addition ('a') or deletion ('d') of a
+    if (F->used + 5 * (size_t) size + 2 > F->cap) flushProof(F);      // clause: each literal as 2*var+sign in 7-bit groups
+    unsigned char *start = F->buf[F->filling], *out = start + F->used; // (at most 5 bytes), then 0
+    *out++ = type;
+    for (int i = 0; i < size; i++)
+    {
+        unsigned u = 2u * abs(lits[i]) + (lits[i] < 0);
+        while (u > 127) *out++ = (u & 127) | 128, u >>= 7;
+        *out++ = u;
+    }
+    *out++ = 0;
+    F->used = out - start;
+    if (type == 'a') F->added++;
+    else F->deleted++;
+}
+
+#ifndef MICROSAT_LIBRARY
+static struct proof* openProof(const char* path, int nVars)
+{                                                                     // Start a proof for clauses of at most nVars literals
+    struct proof* F = (struct proof*) calloc (1, sizeof (struct proof));
+    if (!F) return NULL;
+    F->cap = PROOF_BUFFER;
+    if (F->cap < 5 * (size_t) nVars + 2) F->cap = 5 * (size_t) nVars + 2;
+    F->buf[0] = (unsigned char*) malloc (F->cap);
+    F->buf[1] = (unsigned char*) malloc (F->cap);
+    F->fd = open (path, O_WRONLY | O_CREAT | O_TRUNC, 0644);          // A named pipe streams it to a running checker
+    if (!F->buf[0] || !F->buf[1] || F->fd < 0)
+    {
+        if (F->fd >= 0) close (F->fd);
+        free (F->buf[0]); free (F->buf[1]); free (F);
+        return NULL;
+    }
+    pthread_mutex_init (&F->lock, NULL);
+    pthread_cond_init (&F->cond, NULL);
+    if (pthread_create (&F->writer, NULL, writeProof, F))
+    {
+        close (F->fd);
+        free (F->buf[0]); free (F->buf[1]); free (F);
+        return NULL;
+    }
+    return F;
+}
+
+static int closeProof(struct proof* F)
+{                                                                     // Write the rest and release F; ERROR if a write failed
+    flushProof(F);
+    pthread_mutex_lock (&F->lock);
+    F->closing = true;
+    pthread_cond_broadcast (&F->cond);
+    pthread_mutex_unlock (&F->lock);
+    pthread_join (F->writer, NULL);
+    bool failed = F->failed || close (F->fd);
+    pthread_mutex_destroy (&F->lock);
+    pthread_cond_destroy (&F->cond);
+    free (F->buf[0]); free (F->buf[1]); free (F);
+    return failed ? ERROR : SAT;
+}
+#endif
+
+static double wallTime ()
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static inline int binaryReason(int lit)
+{                                                                     // Reasons < 0 are binary clauses, storing the other
+    return -(2 * abs(lit) + (lit < 0));                               // (false) literal instead of a DB offset
+}
+
+static inline int reasonLit(int reason)
+{                                                                     // Decode the other literal of a binary reason
+    return (-reason & 1) ? -(-reason >> 1) : (-reason >> 1);
+}
+
+template <typename Lit>
+Lit* getMemory (struct solver<Lit>* S, ref mem_size)
 {                                                                     // Allocate memory of size mem_size
     if (S->mem_used + mem_size > S->mem_max)
-    {                                                                 // In case the code is used within a code base
-        printf("c out of memory\n");
-        exit(0);
+    {                                                                 // Grow DB geometrically; pointers into DB move
+        if (mem_size > REF_MAX - S->mem_used) return NULL;            // Offsets would overflow: DB is exhausted
+        ref max = S->mem_max;
+        while (S->mem_used + mem_size > max)
+            max = max > REF_MAX / 2 ? REF_MAX : 2 * max;
+        if (S->memLimit && max > S->memLimit && S->mem_used + mem_size <= S->memLimit)
+            max = S->memLimit;                                        // Do not double past the memory budget
+        Lit *DB = (Lit *) realloc (S->DB, sizeof (Lit) * ((size_t) max + DB_PAD));
+        if (!DB) return NULL;                                         // In case the code is used within a code base
+        S->DB = DB;
+        S->mem_max = max;
     }
-    int *store = (S->DB + S->mem_used);                               // Compute a pointer to the new memory location
+    Lit *store = (S->DB + S->mem_used);                               // Compute a pointer to the new memory location
     S->mem_used += mem_size;                                          // Update the size of the used memory
     return store;
 }
 
-void unassign(struct solver* S, int lit)
+template <typename Lit>
+static void heapUp(struct solver<Lit>* S, int i)
+{                                                                     // Move heap[i] up while its parent is less active
+    int var = S->heap[i];
+    double act = S->activity[var];
+    while (i > 0 && S->activity[S->heap[(i - 1) >> 1]] < act)
+    {
+        S->heap[i] = S->heap[(i - 1) >> 1];
+        S->heapPos[S->heap[i]] = i;
+        i = (i - 1) >> 1;
+    }
+    S->heap[i] = var;
+    S->heapPos[var] = i;
+}
+
+template <typename Lit>
+static void heapDown(struct solver<Lit>* S, int i)
+{                                                                     // Move heap[i] down while a child is more active
+    int var = S->heap[i];
+    double act = S->activity[var];
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= S->heapSize) break;
+        if (child + 1 < S->heapSize && S->activity[S->heap[child + 1]] > S->activity[S->heap[child]]) child++;
+        if (S->activity[S->heap[child]] <= act) break;
+        S->heap[i] = S->heap[child];
+        S->heapPos[S->heap[i]] = i;
+        i = child;
+    }
+    S->heap[i] = var;
+    S->heapPos[var] = i;
+}
+
+template <typename Lit>
+static void heapInsert(struct solver<Lit>* S, int var)
+{
+    S->heap[S->heapSize] = var;
+    heapUp(S, S->heapSize++);
+}
+
+template <typename Lit>
+static int heapPop(struct solver<Lit>* S)
+{                                                                     // Remove and return the most active variable
+    int var = S->heap[0];
+    S->heapPos[var] = -1;
+    if (--S->heapSize)
+    {
+        S->heap[0] = S->heap[S->heapSize];
+        heapDown(S, 0);
+    }
+    return var;
+}
+
+template <typename Lit>
+void unassign(struct solver<Lit>* S, int lit)
 {
     S->fals[lit] = 0;
+    if (S->evsids && S->heapPos[abs(lit)] < 0)                        // Every unassigned variable is in the heap
+        heapInsert(S, abs(lit));
 }
 
-void assign(struct solver* S, int* reason, bool forced)
-{                                                                     // Make the first literal of the reason true
-    int lit = reason[0];                                              // Let lit be the first literal in the reason
+template <typename Lit>
+void assign(struct solver<Lit>* S, int lit, ref reason, bool forced)
+{                                                                     // Make lit true; reason is the first literal of the reason
     S->fals[-lit] = forced ? IMPLIED : 1;                             // Mark lit as true and IMPLIED if forced
     *(S->assigned++) = -lit;                                          // Push it on the assignment stack
-    S->reason[abs(lit)] = (int)((reason)-S->DB);                      // Set the reason clause of lit
+    S->reason[abs(lit)] = reason;                                     // Set the reason clause (DB offset or binary) of lit
+    S->level [abs(lit)] = S->nLevels;
     S->model [abs(lit)] = (lit > 0);                                  // Mark the literal as true in the model
 }
 
-void restart(struct solver* S)
+template <typename Lit>
+void decide(struct solver<Lit>* S, int lit)
+{                                                                     // Assign the decision literal to true
+    S->trailLim[S->nLevels++] = (int) (S->assigned - S->falseStack);  // It opens a new decision level
+    S->level[abs(lit)] = S->nLevels;
+    S->fals[-lit] = 1;
+    *(S->assigned++) = -lit;                                          // And push it on the assigned stack
+    S->reason[abs(lit)] = 0;                                          // Decisions have no reason clauses
+    STAT(S->stats.decisions++);
+}
+
+template <typename Lit>
+void backtrack(struct solver<Lit>* S, int* position)
+{                                                                     // Unassign the trail above position
+    while (S->assigned > position)
+        unassign(S, *(--S->assigned));
+    S->processed = position;
+    while (S->nLevels && S->falseStack + S->trailLim[S->nLevels - 1] >= position)
+        S->nLevels--;                                                 // Close the levels whose decision was undone
+}
+
+template <typename Lit>
+void restart(struct solver<Lit>* S)
 {                                                                     // unassign all variables
     while (S->assigned > S->forced)
         unassign(S, *(--S->assigned));                                // Remove all unforced fals lits from falseStack
     S->processed = S->forced;                                         // Reset the processed pointer
+    S->nLevels = 0;
+}
+
+template <typename Lit>
+int addWatch(struct solver<Lit>* S, int lit, ref cref, int blocker)
+{                                                                     // Append a watch on lit for the clause at DB[cref]
+    struct watchList* ws = &S->watches[lit];
+    if (ws->size == ws->cap)
+    {                                                                 // Grow the watch array geometrically
+        int cap = ws->cap ? 2 * ws->cap : 4;
+        struct watch* w = (struct watch*) realloc (ws->w, sizeof (struct watch) * cap);
+        if (!w) return ERROR;
+        ws->w = w;
+        ws->cap = cap;
+    }
+    ws->w[ws->size].cref = cref;
+    ws->w[ws->size++].blocker = blocker;
+    return SAT;
 }
 
-void addWatch(struct solver* S, int lit, int mem)
-{               
-    S->DB[mem] = S->first[lit];                                       // Add a watch pointer to a clause containing lit
-    S->first[lit] = mem;                                              // By updating the database and the pointers
-}               
+int addImplication(struct binList* bins, int lit, int implied)
+{                                                                     // Record that falsifying lit makes implied true
+    struct binList* bs = &bins[lit];
+    if (bs->size == bs->cap)
+    {                                                                 // Grow the implication array geometrically
+        int cap = bs->cap ? 2 * bs->cap : 4;
+        int* lits = (int*) realloc (bs->lits, sizeof (int) * cap);
+        if (!lits) return ERROR;
+        bs->lits = lits;
+        bs->cap = cap;
+    }
+    bs->lits[bs->size++] = implied;
+    return SAT;
+}
 
-int* addClause(struct solver* S, int* in, int size, int irr) 
+template <typename Lit>
+ref addClause(struct solver<Lit>* S, int* in, int size, int irr, int lbd)
 {                                                                     // Adds a clause stored in *in of size size
-    int i, used = S->mem_used;                                        // Store a pointer to the beginning of the clause
-    int* clause = getMemory (S, size + 3) + 2;                        // Allocate memory for the clause in the database
-    if (size >  1)                                                    // Two watch pointers to the datastructure
-    {
-        addWatch (S, in[0], used  );                                  // If the clause is not unit, then add the first two
-        addWatch (S, in[1], used+1);
+    if (!irr && S->proof) proofLine(S->proof, 'a', in, size);         // Lemmas go to the proof
+    if (size == 2)
+    {                                                                 // Binary clauses live only in the implication lists
+        struct binList* bins = irr ? S->irrBins : S->bins;
+        if (addImplication (bins, in[0], in[1]) == ERROR || addImplication (bins, in[1], in[0]) == ERROR)
+            return ERROR;
+        return binaryReason (in[1]);                                  // Learned binaries are kept and not counted as lemmas
     }
+    ref used = S->mem_used + HEAD<Lit>;                               // Store a pointer to the beginning of the clause
+    Lit *clause = getMemory (S, HEAD<Lit> + size + 1);                // Allocate memory for the clause in the database
+    if (!clause) return ERROR;                                        // ERROR is never a valid reason (see binaryReason)
+    clause += HEAD<Lit>;
+    setHeader(clause, LBD_WORD, lbd);                                 // The header holds the LBD of the clause
+    setHeader(clause, STAMP_WORD, S->nConflicts);                     // and the conflict at which it was last used
+    if (size >  1)                                                    // Two watches to the datastructure
+    {                                                                 // If the clause is not unit, then watch the first two
+        if (addWatch (S, in[0], used, in[1]) == ERROR ||              // literals, each caching the other one as blocker
+            addWatch (S, in[1], used, in[0]) == ERROR)
+            return ERROR;
+    }
+    int i;
     for (i = 0; i < size; i++)
-        clause[i] = in[i];
+        clause[i] = (Lit) in[i];
     clause[i] = 0;                                                    // Copy the clause from the buffer to the database
     if (irr)                                                          //// If the clause is from the input, update [mem_fixed]
         S->mem_fixed = S->mem_used;
     else S->nLemmas++;                                                //// The number of learned clauses increased
-    return clause;
-}                                                                     // Return the pointer to the clause in the database
+    return used;
+}                                                                     // Return the reason that makes in[0] true
+
+static int compareStamps(const void* a, const void* b)
+{
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
 
-void reduceDB(struct solver *S, int k)
-{                                                                     // Removes "less useful" lemmas from DB 
+template <typename Lit>
+static bool keepLemma(struct solver<Lit>* S, ref c, int size, int median)
+{                                                                     // Decide whether the lemma at DB[c] survives a reduction
+    Lit *clause = S->DB + c;
+    int lbd = header(clause, LBD_WORD) & ~LEMMA_FLAGS, stamp = header(clause, STAMP_WORD);
+    if (S->fals[-clause[0]] && S->reason[abs(clause[0])] == c)
+        return true;                                                  // Locked: the reason of an assigned literal
+    if (header(clause, LBD_WORD) & REMOVED) return false;             // Replaced by a shorter lemma
+    if (size < 3 || lbd <= CORE_LBD) return true;                     // Core tier (and unit lemmas) are kept forever
+    if (lbd <= TIER2_LBD && stamp >= S->lastReduce) return true;      // Tier2 lemmas used since the previous reduction
+    return stamp >= median;                                           // Local lemmas: keep the recently used half
+}
+
+template <typename Lit>
+void reduceDB(struct solver<Lit>* S)
+{                                                                     // Removes "less useful" lemmas from DB, in place
+    STAT(double start = wallTime ());
+    STAT(S->stats.reductions++);
     while (S->nLemmas > S->maxLemmas)
-        S->maxLemmas += 300;                                          // Allow more lemmas in the future
-    S->nLemmas = 0;                                                   // Reset the number of learned lemmas
+        S->maxLemmas += S->lemmaInc;                                  // Allow more lemmas in the future
+    int *stamps = (int*) malloc (sizeof (int) * (S->nLemmas + 1)), n = 0;
+    ref *moved = (ref*) malloc (sizeof (ref) * (S->nLemmas + 1));     // New offset of each kept lemma, in kept order
+    if (!stamps || !moved)
+    {                                                                 // Without scratch memory, skip this reduction
+        free (stamps); free (moved);
+        return;
+    }
+    for (ref c = S->mem_fixed + HEAD<Lit>, next; c < S->mem_used; c = next)
+    {                                                                 // Collect the stamps of the local candidates
+        int size = 0;
+        while (S->DB[c + size]) size++;
+        next = c + size + 1 + HEAD<Lit>;
+        if (!keepLemma(S, c, size, INT_MAX)) stamps[n++] = header(S->DB + c, STAMP_WORD);
+    }
+    qsort (stamps, n, sizeof (int), compareStamps);
+    int median = n ? stamps[n / 2] : INT_MAX;
+    ref to = S->mem_fixed + HEAD<Lit>;
+    n = 0;
+    for (ref c = S->mem_fixed + HEAD<Lit>, next; c < S->mem_used; c = next)
+    {                                                                 // Compute the new offset of every kept lemma into moved
+        int size = 0;                                                 // and store its index + 1 in the stamp slot of its
+        while (S->DB[c + size]) size++;                               // header (0 means deleted), saving the stamps in kept
+        next = c + size + 1 + HEAD<Lit>;                              // order (an int slot cannot hold a DB64 offset)
+        if (keepLemma(S, c, size, median))
+        {
+            stamps[n] = header(S->DB + c, STAMP_WORD);
+            moved[n++] = to;
+            setHeader(S->DB + c, STAMP_WORD, n);
+            to += size + 1 + HEAD<Lit>;
+        }
+        else
+        {
+            if (S->proof) proofLine(S->proof, 'd', S->DB + c, size);
+            setHeader(S->DB + c, STAMP_WORD, 0);
+        }
+    }
     for (int i = -S->nVars; i <= S->nVars; i++)
-    {                                                                 // Loop over the variables
-        if (i == 0) continue;
-        int *watch = &S->first[i];                                    // Get the pointer to the first watched clause
-        while (*watch >= S->mem_fixed)                                // According to the characteristic of stack
-			*watch =  S->DB[*watch];                                  // Remove the watch if it points to a lemma
-    }
-    int old_used = S->mem_used;
-    S->mem_used = S->mem_fixed;                                       // Virtually remove all lemmas
-    for (int i = S->mem_fixed + 2; i < old_used; i += 3)
-    {                                                                 // While the old memory contains lemmas
-        int count = 0, head = i, lit;                                 // Get the lemma to which the head is pointing
-        while ((lit = S->DB[i++]))                                    // Count the number of literals that are satisfied by the current model
-            if ((lit > 0) == S->model[abs(lit)])
-                count++;
-        if (count < k)                                                // If the latter is smaller than k, add it back
-            addClause(S, S->DB+head, i-head, 0);
-    }
-}
-
-void bump(struct solver* S, int lit)                                  // Move the variable to the front of the decision list and MARK it
+    {                                                                 // Redirect the watches of kept lemmas
+        struct watchList* ws = &S->watches[i];                        // and drop the ones of deleted lemmas
+        int j = 0;
+        for (int w = 0; w < ws->size; w++)
+            if (ws->w[w].cref < S->mem_fixed)                         // Keep the watches of input clauses
+                ws->w[j++] = ws->w[w];
+            else if (header(S->DB + ws->w[w].cref, STAMP_WORD))
+            {
+                ws->w[j] = ws->w[w];
+                ws->w[j++].cref = moved[header(S->DB + ws->w[w].cref, STAMP_WORD) - 1];
+            }
+        ws->size = j;
+    }
+    for (int* p = S->falseStack; p < S->assigned; p++)
+    {                                                                 // Redirect the reasons of assigned literals
+        ref* reason = &S->reason[abs(*p)];                            // (lemmas that are reasons are always kept)
+        if (*reason >= S->mem_fixed) *reason = moved[header(S->DB + *reason, STAMP_WORD) - 1];
+    }
+    n = 0;
+    for (ref c = S->mem_fixed + HEAD<Lit>, next; c < S->mem_used; c = next)
+    {                                                                 // Slide the kept lemmas down; they only move to lower
+        int size = 0;                                                 // offsets, so the unscanned part is left intact
+        while (S->DB[c + size]) size++;
+        next = c + size + 1 + HEAD<Lit>;
+        if (!header(S->DB + c, STAMP_WORD)) continue;
+        ref dest = moved[n];
+        setHeader(S->DB + c, STAMP_WORD, stamps[n++]);                // Restore the usage stamp
+        memmove (S->DB + dest - HEAD<Lit>, S->DB + c - HEAD<Lit>, sizeof (Lit) * (size + 1 + HEAD<Lit>));
+    }
+    free (stamps); free (moved);
+    S->nLemmas    = n;                                                // The number of lemmas that were kept
+    S->mem_used   = to - HEAD<Lit>;
+    S->lastReduce = S->nConflicts;
+    if (S->mem_max > INIT_MEM && S->mem_used < S->mem_max / 4)
+    {                                                                 // Compact the arena after a large reduction
+        Lit *DB = (Lit *) realloc (S->DB, sizeof (Lit) * ((size_t) (S->mem_max / 2) + DB_PAD));
+        if (DB)
+        {
+            S->DB = DB;
+            S->mem_max /= 2;
+        }
+    }
+    STAT(S->stats.reduceTime += wallTime () - start);
+}
+
+template <typename Lit>
+static void rescaleActivity(struct solver<Lit>* S)
+{                                                                     // Scale all activities down (their order is unchanged)
+    for (int i = 1; i <= S->nVars; i++)
+        S->activity[i] /= RESCALE;
+    S->varInc /= RESCALE;
+}
+
+template <typename Lit>
+void bump(struct solver<Lit>* S, int lit)                             // Move the variable to the front of the decision list and MARK it
 {
     if (S->fals[lit] != IMPLIED)
     {
         S->fals[lit] = MARK;                                          // MARK the literal as involved if not a top-level unit
         int var = abs(lit);
-        if (var != S->head)                                           // In case var is not already the head of the list
+        if (S->evsids)
+        {                                                             // EVSIDS: raise the activity of var instead
+            if ((S->activity[var] += S->varInc) > RESCALE) rescaleActivity(S);
+            if (S->heapPos[var] >= 0) heapUp(S, S->heapPos[var]);
+        }
+        else if (var != S->head)                                           // In case var is not already the head of the list
         {
             S->prev[S->next[var]] = S->prev[var];                     //// Delete [var] from the link
             S->next[S->prev[var]] = S->next[var];                    
@@ -136,232 +696,2593 @@ void bump(struct solver* S, int lit)                                  // Move th
     }
 }
 
-bool implied(struct solver* S, int lit)                               //// Check if lit(eral) is implied (to be false) by MARK literals
-{ 
-    if (S->fals[lit] > MARK)                                          // If checked before, return old result
-		return (S->fals[lit] == IMPLIED);
-    if (!S->reason[abs(lit)]) return false;                           // In case lit is a decision or unassigned, it is 'not implied'
-    int *p = (S->DB + S->reason[abs(lit)]);                           // Get the reason of lit(eral)
-    while (*(++p))                                                    //// Traverse the other literals in the reason
-        if ((S->fals[*p] ^ MARK) && !implied(S, *p))
-		{                                                             // Recursively check if non-MARK literals are implied
-        	S->fals[lit] = NOT_IMPLIED;
-			return false;
-		}
-    S->fals[lit] = IMPLIED;
-	return true;
+template <typename Lit>
+static inline unsigned levelBit(struct solver<Lit>* S, int lit)
+{                                                                     // Abstraction of the level of lit as one of 32 bits
+    return 1u << (S->level[abs(lit)] & 31);
+}
+
+template <typename Lit>
+static inline Lit* reasonLits(struct solver<Lit>* S, ref reason, Lit* bin)
+{                                                                     // The false literals of a reason (0-terminated): a
+    if (reason > 0) return S->DB + reason + 1;                        // clause without its first (true) literal, or the
+    bin[0] = (Lit) reasonLit(reason); bin[1] = 0;                     // other literal of a binary reason, decoded into bin
+    return bin;
+}
+
+template <typename Lit>
+bool implied(struct solver<Lit>* S, int lit, unsigned levels, int* nTouched) //// Check if lit(eral) is implied (to be false) by MARK literals
+{                                                                     // Depth-first search over the reasons with an explicit
+    int *stack = S->minStack, top = 2;                                // stack of frames (literal, next reason literal to check);
+    stack[0] = lit; stack[1] = 0;                                     // results are cached in fals as IMPLIED / NOT_IMPLIED
+    Lit bin[2];
+    while (top)
+    {
+        int q = stack[top - 2];
+        Lit *c = reasonLits(S, S->reason[abs(q)], bin) + stack[top - 1];
+        if (!*c)
+        {                                                             // Every literal of the reason of q is implied
+            if ((top -= 2) == 0) return true;
+            S->fals[q] = IMPLIED;
+            S->touched[(*nTouched)++] = q;
+            continue;
+        }
+        stack[top - 1]++;
+        int f = S->fals[*c];
+        if (f == MARK || f == IMPLIED || !S->level[abs(*c)]) continue;   // In the lemma, implied before, or a root unit
+        if (f == NOT_IMPLIED || !S->reason[abs(*c)] || !(levels & levelBit(S, *c)))
+        {                                                             // A decision, or a level absent from the lemma: no
+            for (int i = 2; i < top; i += 2)                          // literal on the current path is implied
+            {
+                S->fals[stack[i]] = NOT_IMPLIED;
+                S->touched[(*nTouched)++] = stack[i];
+            }
+            return false;
+        }
+        stack[top] = *c; stack[top + 1] = 0;                          // Check the reason of *c first
+        top += 2;
+    }
+    return true;
+}
+
+static unsigned long long lemmaHash(const int* lits, int size)
+{                                                                     // Order-independent hash of a lemma
+    unsigned long long h = size;
+    for (int i = 0; i < size; i++)
+    {                                                                 // Sum of splitmix64-mixed literals
+        unsigned long long x = (unsigned long long) (long long) lits[i] + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        h += x ^ (x >> 31);
+    }
+    return h | 1;                                                     // 0 marks an empty filter entry
+}
+
+template <typename Lit>
+static bool seenBefore(struct solver<Lit>* S, const int* lits, int size)
+{                                                                     // Check and record a lemma in the duplicate filter
+    unsigned long long h = lemmaHash(lits, size), *entry = &S->seen[h % SEEN_SIZE];
+    if (*entry == h) return true;
+    *entry = h;
+    return false;
+}
+
+template <typename Lit>
+void exportLemma(struct solver<Lit>* S, const int* lemma, int size, int lbd)
+{                                                                     // Publish a short or low-LBD lemma to the other workers
+    struct sharing* sh = S->share;
+    if (size > sh->maxSize || lbd > sh->maxLbd) return;
+    struct shareRing* ring = &sh->rings[S->shareId];
+    unsigned h = ring->head.load (std::memory_order_relaxed);
+    struct shareSlot* slot = &ring->slots[h % SHARE_SLOTS];
+    slot->seq.store (2 * h + 1, std::memory_order_relaxed);           // Readers that see an odd seq skip the slot
+    std::atomic_thread_fence (std::memory_order_release);
+    slot->size.store (size, std::memory_order_relaxed);
+    slot->lbd.store (lbd, std::memory_order_relaxed);
+    for (int i = 0; i < size; i++)
+        slot->lits[i].store (lemma[i], std::memory_order_relaxed);
+    slot->seq.store (2 * h + 2, std::memory_order_release);
+    ring->head.store (h + 1, std::memory_order_release);
+    seenBefore(S, lemma, size);                                       // Do not import it back from a peer
+    S->nExported++;
+}
+
+template <typename Lit>
+static int importLemma(struct solver<Lit>* S, int* lits, int size, int lbd)
+{                                                                     // Add a peer's lemma at the top level
+    if (seenBefore(S, lits, size)) return SAT;
+    int n = 0;
+    for (int i = 0; i < size; i++)
+    {
+        if (S->fals[-lits[i]]) return SAT;                            // Satisfied by a top-level unit: skip it
+        if (!S->fals[lits[i]]) lits[n++] = lits[i];                   // Remove top-level false literals
+    }
+    if (n == 0) return UNSAT;                                         // The formula implies the empty clause
+    ref reason = addClause(S, lits, n, 0, lbd);
+    if (reason == ERROR) return ERROR;
+    if (n > 2)                                                        // Count its first use in propagate
+        setHeader(S->DB + reason, LBD_WORD, header(S->DB + reason, LBD_WORD) | IMPORTED);
+    if (n == 1) assign(S, lits[0], reason, 1);                        // Units become forced assignments
+    S->nImported++;
+    return SAT;
+}
+
+template <typename Lit>
+int importLemmas(struct solver<Lit>* S)
+{                                                                     // Import the peers' new lemmas; call only after restart
+    struct sharing* sh = S->share;
+    int lits[SHARE_MAX];
+    for (int w = 0; w < sh->nWorkers; w++)
+    {
+        if (w == S->shareId) continue;
+        struct shareRing* ring = &sh->rings[w];
+        unsigned head = ring->head.load (std::memory_order_acquire), pos = S->readPos[w];
+        if (head - pos > SHARE_SLOTS) pos = head - SHARE_SLOTS;       // Entries older than the ring are lost
+        for (; pos != head; pos++)
+        {
+            struct shareSlot* slot = &ring->slots[pos % SHARE_SLOTS];
+            unsigned seq = slot->seq.load (std::memory_order_acquire);
+            if (seq != 2 * pos + 2) continue;                         // Being overwritten by a newer entry
+            int size = slot->size.load (std::memory_order_relaxed);
+            int lbd  = slot->lbd.load (std::memory_order_relaxed);
+            for (int i = 0; i < size && i < SHARE_MAX; i++)
+                lits[i] = slot->lits[i].load (std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_acquire);
+            if (slot->seq.load (std::memory_order_relaxed) != seq) continue;  // Torn read: the slot was reused
+            int result = importLemma(S, lits, size, lbd);
+            if (result != SAT) return result;
+        }
+        S->readPos[w] = head;
+    }
+    return SAT;
 }
 
-int* analyze(struct solver* S, int* clause)                           // Compute a resolvent from falsified clause
+template <typename Lit>
+ref analyze(struct solver<Lit>* S, Lit* clause)                       // Compute a resolvent from falsified clause
 {
 	S->nConflicts++;                                                  // Bump restarts and update the statistic
-    while (*clause)
-		bump(S, *(clause++));                                         //// MARK all literals in the falsified clause
-    while (S->reason[abs(*(--S->assigned))])
-	{                                                                 // Loop on variables on falseStack until the last decision
-    	if (S->fals[*S->assigned] == MARK)
-		{                                                             // If the tail of the stack is MARK
-        	int *check = S->assigned;                                 // Pointer to check if first-UIP is reached
-            // while (S->fals[*(--check)]!=MARK)                      //// Check for only one MARK literal before decision (included)
-            //     if (!S->reason[abs(*check)])                       //// If so, S->assigned is the first-UIP
-            //         goto build;
-            while (S->reason[abs(*(--check))])                        // An identical process
-                if (S->fals[*check]==MARK) break;
-            if (!S->reason[abs(*(check))] && S->fals[*(check)]!=MARK) break;
-            clause = S->DB + S->reason[abs(*S->assigned)];            //// Spread the MARK all the other literals in the reason[*S->assighed]
-            while (*(++clause))
-                bump(S, *clause);
-        }                                                             // MARK all literals in reason
-        unassign(S, *S->assigned);                                    // Unassign the tail of the stack
-    }
-build:                                                                //// Now S->assigned pointed at the first-UIP (may be decision) (not unassigned)
-                                                                      //// MARKs form an initial conflict clause
-    int *p = S->processed = S->assigned;                              //// Since the first-UIP must be propagated, now S->processed > S->assigned
-    int size = 0, lbd = 0, flag = 0;                                  // Build conflict clause; Empty the clause buffer
-    while (p >= S->forced)
-    {                                                                 // Only literals on the stack can be MARKed
-        if ((S->fals[*p] == MARK) && !implied(S, *p))
-        {                                                             // If MARKed and not implied
-            S->buffer[size++] = *p;
-            flag = 1;
-        }                                                             // Add literal to conflict clause buffer
-        if (!S->reason[abs(*p)])
-        {
-            lbd += flag;
-            flag = 0;                                                 // Increase LBD for a decision with a true flag
-            if (size == 1) S->processed = p;                          //// Update the position for backtracking
-        }                                                             // And update the processed pointer
-        S->fals[*(p--)] = 1;
-    }                                                                 // Reset the MARK flag for all variables on the stack
+    int size = 1, pathC = 0, nTouched = 0, *p = S->assigned;          // buffer[0] is reserved for the first UIP
+    Lit bin[2];
+    for (;;)
+    {
+        for (; *clause; clause++)
+        {                                                             //// Bump and MARK the literals of the clause (root units
+            int var = abs(*clause);                                   // never take part); the new ones of the conflict level
+            if (!S->level[var]) continue;                             // are resolved, the others go to the conflict clause
+            bool seen = S->fals[*clause] == MARK;
+            bump(S, *clause);
+            if (seen) continue;
+            S->touched[nTouched++] = *clause;
+            if (S->level[var] == S->nLevels) pathC++;
+            else S->buffer[size++] = *clause;
+        }
+        while (S->fals[*(--p)] != MARK);                              // The next MARK literal on the trail
+        if (!--pathC) break;                                          //// The last one of the conflict level is the first UIP
+        ref reason = S->reason[abs(*p)];                              //// Spread the MARK to the other literals of its reason
+        if (reason > 0) setHeader(S->DB + reason, STAMP_WORD, S->nConflicts); // Stamp the reason clause as used
+        clause = reasonLits(S, reason, bin);
+    }
+    S->buffer[0] = *p;
+    unsigned levels = 0;                                              // Levels of the conflict clause, for early cutoff
+    for (int i = 1; i < size; i++) levels |= levelBit(S, S->buffer[i]);
+    int n = 1, lbd = 1;
+    S->levelStamp[S->nLevels] = S->nConflicts;
+    for (int i = 1; i < size; i++)
+    {                                                                 // Drop the literals implied by the others, and count
+        int lit = S->buffer[i], l = S->level[abs(lit)];               // the levels of the kept ones (LBD)
+        if (S->reason[abs(lit)] && implied(S, lit, levels, &nTouched))
+        {
+            STAT(S->stats.minimized++);
+            continue;
+        }
+        if (S->levelStamp[l] != S->nConflicts) S->levelStamp[l] = S->nConflicts, lbd++;
+        S->buffer[n++] = lit;
+        if (l > S->level[abs(S->buffer[1])])                          // Keep a literal of the highest remaining level in
+        {                                                             // buffer[1]: it is watched and sets the backjump
+            S->buffer[n-1] = S->buffer[1];
+            S->buffer[1] = lit;
+        }
+    }
+    size = n;
+    for (int i = 0; i < nTouched; i++)
+        S->fals[S->touched[i]] = 1;                                   // Reset the MARK flag of the touched literals only
     S->fast -= S->fast >>  5;
     S->fast += lbd << 15;                                             // Update the fast moving average
     S->slow -= S->slow >> 15;
     S->slow += lbd <<  5;                                             // Update the slow moving average
-    while (S->assigned > S->processed)                                //// Perform non-chronological backtracking as described
-        unassign(S, *(S->assigned--));
-    unassign(S, *S->assigned);                                        // Assigned now equal to processed
+    if (S->evsids && (S->varInc /= VAR_DECAY) > RESCALE)              // Later bumps weigh more: the activities decay
+        rescaleActivity(S);
+    int jump = size > 1 ? S->level[abs(S->buffer[1])] : 0;            //// Perform non-chronological backtracking to the
+    if (S->chrono && jump && S->nLevels - jump > S->chrono)           //// decision of the level above the backjump level
+    {                                                                 // or, for a long jump, only undo the conflict level:
+        S->nChrono++;                                                 // the UIP is then implied at that level, which keeps
+        S->chronoLits += S->trailLim[S->nLevels - 1] - S->trailLim[jump]; // the levels on the trail in order (units still
+        jump = S->nLevels - 1;                                        // jump to the root)
+    }
+    backtrack(S, S->falseStack + S->trailLim[jump]);
     S->buffer[size] = 0;                                              // Terminate the buffer (and potentially print clause)
-    return addClause(S, S->buffer, size, 0);                          // Add new conflict clause to redundant DB
+    STAT(S->stats.lemmaSize[size < HIST_SIZE ? size : HIST_SIZE - 1]++);
+    STAT(S->stats.lemmaLbd [lbd  < HIST_SIZE ? lbd  : HIST_SIZE - 1]++);
+    if (S->share) exportLemma(S, S->buffer, size, lbd);               // Offer the lemma to the other workers
+    return addClause(S, S->buffer, size, 0, lbd);                     // Add new conflict clause to redundant DB, and return
+}                                                                     // its reason (or ERROR); the lemma stays in S->buffer
+
+template <typename Lit>
+static int scanScalar(const unsigned char* fals, const Lit* clause, int k)
+{                                                                     // The first k from k on with clause[k] unassigned,
+    while (clause[k] && fals[clause[k]]) k++;                         // true or the terminating zero
+    return k;
+}
+
+#ifdef SIMD_SCAN
+__attribute__ ((target ("avx2")))
+static inline __m256i load8(const int* lits) { return _mm256_loadu_si256((const __m256i*) lits); }
+
+__attribute__ ((target ("avx2")))
+static inline __m256i load8(const short* lits) { return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) lits)); }
+
+__attribute__ ((target ("avx512f")))
+static inline __m512i load16(const int* lits) { return _mm512_loadu_si512((const void*) lits); }
+
+__attribute__ ((target ("avx512f")))                                  // (16-bit literals are widened to 32 bits; the maskz
+static inline __m512i load16(const short* lits)                       // form keeps GCC 12 from warning about its own header)
+{
+    return _mm512_maskz_cvtepi16_epi32(0xffff, _mm256_loadu_si256((const __m256i*) lits));
+}
+
+template <typename Lit>
+__attribute__ ((target ("avx2")))
+static int scanAVX2(const unsigned char* fals, const Lit* clause, int k)
+{                                                                     // scanScalar for 8 literals at a time: gather their
+    const __m256i zero = _mm256_setzero_si256(), low = _mm256_set1_epi32(0xff); // fals bytes up to the terminator and
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);  // stop at the first zero of either
+    for (;;)
+    {                                                                 // (the loads stay within DB_PAD past the terminator)
+        __m256i lits = load8(clause + k);
+        unsigned ends = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lits, zero)));
+        __m256i valid = _mm256_cmpgt_epi32(_mm256_set1_epi32(ends ? __builtin_ctz (ends) : 8), lanes);
+        __m256i vals = _mm256_mask_i32gather_epi32(zero, (const int*) fals, lits, valid, 1);
+        __m256i open = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(vals, low), zero), valid);
+        unsigned stop = _mm256_movemask_ps(_mm256_castsi256_ps(open)) | ends;
+        if (stop) return k + __builtin_ctz (stop);
+        k += 8;
+    }
+}
+
+template <typename Lit>
+__attribute__ ((target ("avx512f")))
+static int scanAVX512(const unsigned char* fals, const Lit* clause, int k)
+{                                                                     // The same for 16 literals at a time
+    const __m512i zero = _mm512_setzero_si512(), low = _mm512_set1_epi32(0xff);
+    for (;;)
+    {
+        __m512i lits = load16(clause + k);
+        unsigned ends = _mm512_cmpeq_epi32_mask(lits, zero);
+        __mmask16 valid = ends ? (ends & -ends) - 1 : 0xffff;         // The lanes before the terminator
+        __m512i vals = _mm512_mask_i32gather_epi32(zero, valid, lits, (const void*) fals, 1);
+        unsigned stop = _mm512_mask_cmpeq_epi32_mask(valid, _mm512_and_si512(vals, low), zero) | ends;
+        if (stop) return k + __builtin_ctz (stop);
+        k += 16;
+    }
+}
+#endif
+
+template <typename Lit>
+using scanKernel = int (*)(const unsigned char*, const Lit*, int);
+
+template <typename Lit>
+static scanKernel<Lit> scanClause = scanScalar<Lit>;                  // Shared by all solvers of a width; see --simd
+
+#ifndef MICROSAT_LIBRARY
+template <typename Lit>
+static scanKernel<Lit> pickScan()
+{                                                                     // The widest scan this CPU runs
+#ifdef SIMD_SCAN
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx512f")) return scanAVX512<Lit>;
+    if (__builtin_cpu_supports ("avx2"))    return scanAVX2<Lit>;
+#endif
+    return scanScalar<Lit>;
+}
+
+template <typename Lit>
+static const char* scanName()
+{
+#ifdef SIMD_SCAN
+    if (scanClause<Lit> == scanAVX512<Lit>) return "avx512";
+    if (scanClause<Lit> == scanAVX2<Lit>)   return "avx2";
+#endif
+    return "scalar";
 }
+#endif
 
-int propagate(struct solver* S)                                       // Performs unit propagation
+template <typename Lit>
+int propagate(struct solver<Lit>* S)                                  // Performs unit propagation
 {
-    bool forced = S->reason[abs(*S->processed)];                      //// Only if no decision was made might [forced] be true
+    bool forced = !S->nLevels;                                        //// Only if no decision was made might [forced] be true
+    int *binProcessed = S->processed;                                 // Binary implications run ahead of the long watches
+    Lit bin[3];
     while (S->processed < S->assigned)
     {                                                                 // While unprocessed false literals
-        int lit = *(S->processed++);                                  //// lit is falsified but not propagated yet
-        int *watch = &S->first[lit];                                  //// Handle all the clauses watching lit (remove the associating watchers)
-        while (*watch != END)
-        {
-            bool unit = true;
-            int *clause = S->DB + *watch;	                          // Get the clause from DB
-            if (clause[-1]==0) clause+=2;                             // Set the pointer to the first literal in the clause
-            else clause++;
-            if (clause[0]==lit) clause[0]=clause[1];                  // Ensure that the other watched literal is in front
-            for (int i=2; unit&&clause[i]; i++)                       // Scan the non-watched literals
-                if (!S->fals[clause[i]])
-                {                                                     // When clause[i] is not false, it is either true or unset
-                    unit = false;
-                    clause[1] = clause[i];
-					clause[i] = lit;                                  //// Finish swapping literals (keep the clause for backtracking)
-                    int store = *watch;                               // Store the old watch
-                    *watch = S->DB[*watch];                           // Remove the watch from the list of lit
-                    addWatch(S, clause[1], store); 
-                }                                                     // Add the watch to the list of clause[1]
-            if (unit)
+        Lit *conflict = NULL;
+        while (!conflict && binProcessed < S->assigned)
+        {                                                             // First propagate the binary clauses of the whole trail
+            int lit = *(binProcessed++);
+            const struct binList* lists[2] = { &S->irrBins[lit], &S->bins[lit] };
+            for (int l = 0; !conflict && l < 2; l++)
+                for (int k = 0; k < lists[l]->size; k++)
+                {                                                     // Input binaries first, then learned ones
+                    int other = lists[l]->lits[k];
+                    if (S->fals[-other]) continue;                    // If the implied literal is satisfied, continue
+                    if (!S->fals[other])
+                        assign(S, other, binaryReason(lit), forced);  // Unassigned: assign it with a binary reason
+                    else
+                    {                                                 // Falsified: a conflict is found by the binary clause
+                        bin[0] = (Lit) other; bin[1] = (Lit) lit; bin[2] = 0;
+                        conflict = bin;
+                        break;
+                    }
+                }
+        }
+        if (!conflict)
+        {                                                             // Then the long clauses of the next trail literal
+            int lit = *(S->processed++);                              //// lit is falsified but not propagated yet
+            S->nPropagations++;
+            struct watchList* ws = &S->watches[lit];                  //// Handle all the clauses watching lit
+            struct watch *i = ws->w, *j = ws->w, *end = ws->w + ws->size; // Watches are compacted in place
+            while (i < end)
             {
-                clause[1] = lit;                                      //// At most two literals,and lit is in clause[1]
-                watch = (S->DB + *watch);                             // Place lit at clause[1] and update next watch
-                if (S->fals[-clause[0]]) continue;                    // If the other watched literal is satisfied, continue
-                else if (!S->fals[clause[0]])                         //// If the other watched literal is unassigned,
-                    assign(S, clause, forced);                        //// the clause is unit for clause[0], thus assign
-                else                                                  //// If the other watched literal is falsified,
-                {                                                     //// a conflict is found by clause
-                    if (forced) return UNSAT;                         // Found a root level conflict -> UNSAT
-                    int* lemma = analyze(S, clause);                  // Analyze the conflict return a conflict clause
-                    if (!lemma[1]) forced = true;                     //// In case the conflict clause is unit set forced flag
-                    assign(S, lemma, forced);
-                    break;
+                STAT(S->stats.watchVisits++);
+                if (S->fals[-i->blocker])
+                {                                                     // If the blocker is satisfied, so is the clause:
+                    *j++ = *i++;                                      // keep the watch without touching the clause
+                    continue;
+                }
+                Lit *clause = S->DB + i->cref;                        // Get the clause from DB, and fetch the
+                if (i + 1 < end) PREFETCH (S->DB + i[1].cref);        // next one meanwhile
+                if (clause[0]==lit) clause[0]=clause[1];              // Ensure that the other watched literal is in front
+                struct watch w = { (i++)->cref, clause[0] };          // The other watched literal becomes the blocker
+                if (S->fals[-clause[0]])
+                {                                                     // If the other watched literal is satisfied, continue
+                    clause[1] = lit;                                  //// lit stays in clause[1] (stored late, see below)
+                    *j++ = w;
+                    continue;
+                }
+                int k = 2;
+                while (clause[k] && S->fals[clause[k]])               // Scan the non-watched literals (the vector
+                    if (++k == SCAN_SCALAR)                           // kernel takes over in long clauses)
+                    {
+                        k = scanClause<Lit>(S->fals, clause, k);
+                        break;
+                    }
+                STAT(S->stats.clauseVisits += k - 1);                 // (clause[0] and clause[2..k] were read)
+                if (clause[k])
+                {                                                     // When clause[k] is not false, it is either true or unset
+                    clause[1] = clause[k];
+                    clause[k] = lit;                                  //// Finish swapping literals (keep the clause for backtracking)
+                    if (addWatch(S, clause[1], w.cref, clause[0]) == ERROR)
+                    {                                                 // Move the watch to the list of clause[1]
+                        while (i < end) *j++ = *i++;
+                        ws->size = (int) (j - ws->w);
+                        return ERROR;
+                    }
+                    continue;
+                }
+                clause[1] = lit;                                      //// No replacement: lit stays in clause[1], stored only
+                *j++ = w;                                             //// now (a 16-bit store there can share a word with
+                                                                      //// clause[2] and stall the scan that reads it)
+                if (header(clause, LBD_WORD) & IMPORTED)
+                {                                                     // First propagation by a lemma of another worker
+                    setHeader(clause, LBD_WORD, header(clause, LBD_WORD) & ~IMPORTED);
+                    S->nImportUsed++;
+                }
+                if (!S->fals[clause[0]])                              //// If the other watched literal is unassigned,
+                    assign(S, clause[0], w.cref, forced);             //// the clause is unit for clause[0], thus assign
+                else
+                {                                                     //// If the other watched literal is falsified,
+                    conflict = clause;                                //// a conflict is found by clause
+                    setHeader(clause, STAMP_WORD, S->nConflicts);     // Stamp the conflict clause as used
+                    while (i < end) *j++ = *i++;                      // Keep the remaining watches
                 }
             }
+            ws->size = (int) (j - ws->w);
+        }
+        if (conflict)
+        {
+            if (forced || !S->nLevels) return UNSAT;                  // Found a root level conflict -> UNSAT
+            if (S->probing) return UNKNOWN;                           // The caller backtracks without a lemma
+            ref reason = analyze(S, conflict);                        // Analyze the conflict return a conflict clause
+            if (reason == ERROR) return ERROR;                        // The lemma could not be stored
+            if (!S->buffer[1]) forced = true;                         //// In case the conflict clause is unit set forced flag
+            assign(S, S->buffer[0], reason, forced);
+            binProcessed = S->processed;                              // Both passes resume at the backjump point
         }
     }                                                                 // Assign the conflict clause as a unit
     if (forced) S->forced = S->processed;	                          // Set S->forced if applicable
     return SAT;
 }
 
-int solve(struct solver* S)
-{                                                                     // Determine satisfiability 
-    int decision = S->head;
-    for (;;)
-    {                                                                 // Main solve loop
-        int old_nLemmas = S->nLemmas;                                 // Store nLemmas to see whether propagate adds lemmas
-        if (propagate(S) == UNSAT) return UNSAT;                      // Propagation returns UNSAT for a root level conflict
-        if (S->nLemmas > old_nLemmas)
-        {                                                             // If the last decision caused a conflict
-            decision = S->head;                                       // Reset the decision heuristic to head
-            if (S->fast > (S->slow / 100) * 125)
-            {                                                         // If fast average is substantially larger than slow average
-//				printf("c restarting after ** conflicts (%i %i) %i\n", S->fast, S->slow, S->nLemmas > S->maxLemmas);
-                S->fast = (S->slow / 100) * 125;
-                restart(S);                                           // Restart and update the averages
-                if (S->nLemmas > S->maxLemmas)
-					reduceDB(S, 6);                                   // Reduce the DB when it contains too many lemmas
-            }
-        }
-        while (S->fals[decision] || S->fals[-decision])               // As long as the temporay decision is assigned
-            decision = S->prev[decision];                             // Replace it with the next variable in the decision list
-        if (decision == 0) return SAT;                                // If the end of the list is reached, then a solution is found
-        decision = S->model[decision] ? decision : -decision;         // Otherwise, assign the decision variable based on the model
-        S->fals[-decision] = 1;                                       // Assign the decision literal to true (change to IMPLIED-1?)
-        *(S->assigned++) = -decision;                                 // And push it on the assigned stack
-        decision = abs(decision);
-        S->reason[decision] = 0;                                      // Decisions have no reason clauses
-    }
+template <typename Lit>
+void printProgress(struct solver<Lit>* S)
+{                                                                     // One line on the state of the search
+    double now = wallTime ();
+    S->nextProgress = now + S->progress;
+    printf ("c progress: %.1f s conflicts: %i propagations: %lld lemmas: %i mem: %lld",
+            now - S->startTime, S->nConflicts, S->nPropagations, S->nLemmas, (long long) S->mem_used);
+#ifdef STATS
+    printf (" decisions: %lld restarts: %i reductions: %lld",
+            S->stats.decisions, S->nRestarts, S->stats.reductions);
+#endif
+    printf ("\n");
+    fflush (stdout);
+}
+
+static unsigned nextRandom(unsigned* state)
+{                                                                     // xorshift32
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state <<  5;
+    return *state;
 }
 
-void initCDCL(struct solver* S, int n, int m)
+struct walker
+{                                                                     // ProbSAT over a flat copy of the input clauses
+    int nVars, nClauses, nLits, nUnsat;                               // without root level literals
+    int *lits, *start;                                                // 0-terminated clauses, one after the other
+    int *occs, *occStart;                                             // Clauses of literal l: occs[occStart[l]..occStart[l+1]-1]
+    int *nTrue, *crit;                                                // True literals of each clause and the XOR of their
+    int *breaks, *unsat, *unsatPos;                                   // variables; clauses each flip would falsify; the
+    int *flipped, nFlipped;                                           // falsified clauses; flips since the best assignment
+    char *value, *best;
+};
+
+static void freeWalker(struct walker* W)
 {
-    if (n < 1)      n = 1;                                            // The code assumes that there is at least one variable
-    S->nVars          = n;                                            // Set the number of variables
-    S->nClauses       = m;                                            // Set the number of clauses
-    S->mem_max        = 1 << 30;                                      // Set the initial maximum memory
-    S->mem_used       = 0;                                            // The number of integers allocated in the DB
-    S->nLemmas        = 0;                                            // The number of learned clauses -- redundant means learned
-    S->nConflicts     = 0;                                            // Number of conflicts used to update scores
-    S->maxLemmas      = 2000;                                         // Initial maximum number of learned clauses
-    S->fast = S->slow = 1 << 24;                                      // Initialize the fast and slow moving averages
+    if (W->occStart) free (W->occStart - W->nVars);
+    free (W->lits); free (W->start); free (W->occs); free (W->nTrue); free (W->crit);
+    free (W->breaks); free (W->unsat); free (W->unsatPos); free (W->flipped);
+    free (W->value); free (W->best);
+}
 
-    S->DB = (int *) malloc (sizeof (int) * S->mem_max);               // Allocate the initial database
-    S->model       = getMemory (S, n+1);                              // Full assignment of the (Boolean) variables (initially set to fals)
-    S->next        = getMemory (S, n+1);                              // Next variable in the heuristic order
-    S->prev        = getMemory (S, n+1);                              // Previous variable in the heuristic order
-    S->buffer      = getMemory (S, n  );                              // A buffer to store a temporary clause
-    S->reason      = getMemory (S, n+1);                              // Array of clauses
-    S->falseStack  = getMemory (S, n+1);                              // Stack of falsified literals -- this pointer is never changed
-    S->forced      = S->falseStack;                                   // Points inside *falseStack at first decision (unforced literal)
-    S->processed   = S->falseStack;                                   // Points inside *falseStack at first unprocessed literal
-    S->assigned    = S->falseStack;                                   // Points inside *falseStack at last unprocessed literal
-    S->fals        = getMemory (S, 2*n+1); S->fals += n;              // Labels for variables, non-zero means false 
-    S->first       = getMemory (S, 2*n+1); S->first += n;             // Offset of the first watched clause （链式栈的栈顶标志）
-    S->DB[S->mem_used++] = 0;                                         // Make sure there is a 0 before the clauses are loaded.
+template <typename Lit>
+static int walkClause(struct walker* W, struct solver<Lit>* S, const Lit* clause, int size, bool count)
+{                                                                     // Copy a clause without its root level literals (or
+    int n = 0;                                                        // only count them); UNSAT if none is left
+    for (int i = 0; i < size; i++)
+    {
+        if (S->fals[-clause[i]]) return SAT;                          // Satisfied at the root level: leave it out
+        if (S->fals[clause[i]]) continue;
+        if (!count) W->lits[W->nLits + n] = clause[i];
+        n++;
+    }
+    if (!n) return UNSAT;                                             // (a root conflict that is not propagated yet)
+    if (!count)
+    {
+        W->start[W->nClauses] = W->nLits;
+        W->lits[W->nLits + n] = 0;
+    }
+    W->nClauses++;
+    W->nLits += n + 1;
+    return SAT;
+}
 
-    for (int i = 1; i <= n; i++)
-    {                                                                 // Initialize the main datastructures:
-        S->prev[i] = i-1;
-        S->next[i-1] = i;                                             // the double-linked list for variable-move-to-front,
-        S->model[i] = S->fals[-i] = S->fals[i] = 0;                   // the model (phase-saving), the fals array,
-        S->first[i] = S->first[-i] = END;
-    }                                                                 // and first (watch pointers).
-	S->head = n;                                                      // Initialize the head of the double-linked list
+template <typename Lit>
+static int buildWalker(struct walker* W, struct solver<Lit>* S, bool count)
+{                                                                     // Collect the long input clauses and the input binaries
+    W->nClauses = W->nLits = 0;
+    for (ref c = 1 + HEAD<Lit>, next; c < S->mem_fixed; c = next)
+    {
+        int size = 0;
+        while (S->DB[c + size]) size++;
+        next = c + size + 1 + HEAD<Lit>;
+        if (size > 1 && walkClause(W, S, S->DB + c, size, count) == UNSAT) return UNSAT;
+    }
+    for (int lit = -S->nVars; lit <= S->nVars; lit++)
+        for (int i = 0; i < S->irrBins[lit].size; i++)
+        {                                                             // Each binary is in the lists of both its literals
+            Lit bin[2] = { (Lit) lit, (Lit) S->irrBins[lit].lits[i] };
+            if (lit < bin[1] && walkClause(W, S, bin, 2, count) == UNSAT) return UNSAT;
+        }
+    return SAT;
 }
 
-static void read_until_new_line (FILE * input)
-{
-    int ch;
-    while ((ch = getc (input)) != '\n')
-        if (ch == EOF)
-        {
-            printf ("parse error: unexpected EOF");
-            exit (1);
+static void walkFlip(struct walker* W, int var)
+{                                                                     // Flip var and update the counts of its clauses
+    int lit = W->value[var] ? -var : var;                             // lit becomes true, -lit false
+    W->value[var] ^= 1;
+    for (int i = W->occStart[lit]; i < W->occStart[lit + 1]; i++)
+    {
+        int c = W->occs[i];
+        if (W->nTrue[c]++ == 0)
+        {                                                             // Satisfied now, with var as its only true literal
+            int last = W->unsat[--W->nUnsat];
+            W->unsat[W->unsatPos[c]] = last;
+            W->unsatPos[last] = W->unsatPos[c];
+            W->breaks[var]++;
         }
+        else if (W->nTrue[c] == 2) W->breaks[W->crit[c]]--;          // The previously critical variable is not anymore
+        W->crit[c] ^= var;
+    }
+    for (int i = W->occStart[-lit]; i < W->occStart[-lit + 1]; i++)
+    {
+        int c = W->occs[i];
+        W->crit[c] ^= var;
+        if (--W->nTrue[c] == 0)
+        {                                                             // Falsified by the flip
+            W->unsatPos[c] = W->nUnsat;
+            W->unsat[W->nUnsat++] = c;
+            W->breaks[var]--;
+        }
+        else if (W->nTrue[c] == 1) W->breaks[W->crit[c]]++;          // Its remaining true literal became critical
+    }
+    if (W->nFlipped < W->nVars) W->flipped[W->nFlipped] = var;
+    W->nFlipped++;
 }
 
-int parse (struct solver* S, char* filename)
-{                                                                          // Parse the formula and initialize
-    int tmp;
-    FILE* input = fopen (filename, "r");                                   // Read the CNF file
-    while ((tmp = getc (input)) == 'c')
-        read_until_new_line (input);
-    ungetc (tmp, input);
-    do
+static void saveBest(struct walker* W)
+{                                                                     // Copy the current assignment to best: only the flipped
+    if (W->nFlipped <= W->nVars)                                      // variables, unless there were more flips than variables
+        for (int i = 0; i < W->nFlipped; i++) W->best[W->flipped[i]] = W->value[W->flipped[i]];
+    else memcpy (W->best, W->value, W->nVars + 1);
+    W->nFlipped = 0;
+}
+
+template <typename Lit>
+int walk(struct solver<Lit>* S)
+{                                                                     // ProbSAT from the saved phases at the root level; the
+    struct walker W;                                                  // best assignment becomes the saved phases. SAT if it
+    memset (&W, 0, sizeof (W));                                       // satisfies the input clauses, so that the next descent
+    W.nVars = S->nVars;                                               // of CDCL finds the model without conflicts
+    int n = S->nVars, result = buildWalker(&W, S, true);
+    if (result == UNSAT) return UNKNOWN;                              // Leave the root conflict to propagate
+    W.lits     = (int*) malloc (sizeof (int) * (W.nLits + 1));
+    W.start    = (int*) malloc (sizeof (int) * (W.nClauses + 1));
+    W.occs     = (int*) malloc (sizeof (int) * (W.nLits + 1));
+    W.occStart = (int*) calloc (2*n+2, sizeof (int));
+    W.nTrue    = (int*) calloc (W.nClauses + 1, sizeof (int));
+    W.crit     = (int*) calloc (W.nClauses + 1, sizeof (int));
+    W.unsat    = (int*) malloc (sizeof (int) * (W.nClauses + 1));
+    W.unsatPos = (int*) malloc (sizeof (int) * (W.nClauses + 1));
+    W.breaks   = (int*) calloc (n+1, sizeof (int));
+    W.flipped  = (int*) malloc (sizeof (int) * (n+1));
+    W.value    = (char*) malloc (n+1);
+    W.best     = (char*) malloc (n+1);
+    if (W.occStart) W.occStart += n;
+    if (!W.lits || !W.start || !W.occs || !W.occStart || !W.nTrue || !W.crit || !W.unsat ||
+        !W.unsatPos || !W.breaks || !W.flipped || !W.value || !W.best)
+    {                                                                 // Without scratch memory, skip this search
+        freeWalker(&W);
+        return UNKNOWN;
+    }
+    buildWalker(&W, S, false);
+    for (int i = 0; i < W.nLits; i++) W.occStart[W.lits[i]] += W.lits[i] != 0; // Occurrence lists: count, then fill from
+    for (int l = -n + 1; l <= n + 1; l++) W.occStart[l] += W.occStart[l - 1];  // the running end of each literal down
+    for (int c = 0; c < W.nClauses; c++)
+        for (int* l = W.lits + W.start[c]; *l; l++) W.occs[--W.occStart[*l]] = c;
+    for (int v = 1; v <= n; v++)
+        W.value[v] = W.best[v] = S->fals[v] ? 0 : S->fals[-v] ? 1 : (char) S->model[v];
+    for (int c = 0; c < W.nClauses; c++)
+    {                                                                 // Initial counts
+        for (int* l = W.lits + W.start[c]; *l; l++)
+            if (W.value[abs(*l)] == (*l > 0)) W.nTrue[c]++, W.crit[c] ^= abs(*l);
+        if (W.nTrue[c] == 1) W.breaks[W.crit[c]]++;
+        else if (!W.nTrue[c]) W.unsatPos[c] = W.nUnsat, W.unsat[W.nUnsat++] = c;
+    }
+    double probs[WALK_PROBS], weights[64];
+    for (int b = 0; b < WALK_PROBS; b++) probs[b] = pow (WALK_EPS + b, -WALK_CB);
+    unsigned seed = (unsigned) S->nWalks * 2654435761u + S->nConflicts + 1;
+    long long flips = 0, budget = 100000 + 10LL * W.nLits;            // Flips in proportion to the formula
+    int bestUnsat = W.nUnsat;
+    while (W.nUnsat && flips < budget)
     {
-        tmp = fscanf (input," p cnf %i %i \n", &S->nVars, &S->nClauses);   // Find the first non-comment line
-        if (tmp > 0 && tmp != EOF) 
-            break;
-        tmp = fscanf (input, "%*s\n");
-    } while (tmp != 2 && tmp != EOF);                                      // Skip it and read next line
-    initCDCL(S, S->nVars, S->nClauses);                                    // Allocate the main datastructures
-    int nZeros = S->nClauses, size = 0;                                    // Initialize the number of clauses to read
-    while (nZeros > 0)
-    {                                                                      // While there are clauses in the file
-        int ch = getc (input);
-        if (ch == ' ' || ch == '\n') continue;
-        if (ch == 'c')
+        int c = W.unsat[nextRandom(&seed) % W.nUnsat], k = 0;
+        double sum = 0;
+        for (int* l = W.lits + W.start[c]; *l; l++, k++)
+        {                                                             // Weigh the variables of a random falsified clause
+            int b = W.breaks[abs(*l)];                                // by how many clauses flipping them would falsify
+            sum += k < 64 ? (weights[k] = probs[b < WALK_PROBS ? b : WALK_PROBS - 1]) : 0;
+        }
+        double r = sum * (nextRandom(&seed) / 4294967296.0);
+        int* l = W.lits + W.start[c];
+        for (k = 0; l[k + 1] && k < 63 && (r -= weights[k]) >= 0; k++);
+        walkFlip(&W, abs(l[k]));
+        flips++;
+        if (W.nUnsat < bestUnsat)
         {
-            read_until_new_line (input);
-            continue;
+            bestUnsat = W.nUnsat;
+            saveBest(&W);
         }
-        ungetc (ch, input);
-        int lit = 0;
+    }
+    for (int v = 1; v <= n; v++)
+        if (!S->fals[v] && !S->fals[-v]) S->model[v] = W.best[v];   // The best assignment becomes the phases
+    S->nWalks++;
+    S->walkFlips += flips;
+    S->walkBest = bestUnsat;
+    freeWalker(&W);
+    return bestUnsat ? UNKNOWN : SAT;
+}
+
+template <typename Lit>
+static int reusedLevels(struct solver<Lit>* S)
+{                                                                     // The decision levels a restart can keep: those whose
+    int next = S->head, mark = -S->nConflicts - 1;                    // decision the heuristic prefers to the variable it
+    if (S->evsids)                                                    // would decide next
+    {
+        while (S->heapSize && (S->fals[S->heap[0]] || S->fals[-S->heap[0]]))
+            heapPop(S);                                               // (assigned variables return to the heap later)
+        if (!S->heapSize) return S->nLevels;
+        next = S->heap[0];
+        for (int i = 0; i < S->nLevels; i++)
+            if (S->activity[abs(S->falseStack[S->trailLim[i]])] <= S->activity[next]) return i;
+        return S->nLevels;
+    }
+    for (; next && (S->fals[next] || S->fals[-next]); next = S->prev[next])
+        if (!S->reason[next] && S->level[next])                       // Decisions in front of next in the list: flag their
+            S->levelStamp[S->level[next]] = mark;                     // levels (analyze stamps levels with conflicts > 0)
+    int keep = 0;
+    while (keep < S->nLevels && S->levelStamp[keep + 1] == mark) keep++;
+    return keep;
+}
+
+template <typename Lit>
+void restartReuse(struct solver<Lit>* S)
+{                                                                     // Restart, but keep the trail up to the first decision
+    int keep = 0;                                                     // the heuristic would change (lemma import and
+    if (S->reuse && !S->share && !S->nAssumptions)                    // assumptions need a full restart)
+        keep = reusedLevels(S);
+    if (!keep)
+    {
+        restart(S);
+        return;
+    }
+    int* position = keep < S->nLevels ? S->falseStack + S->trailLim[keep] : S->assigned;
+    S->nReuses++;
+    S->reusedLits += position - S->forced;
+    backtrack(S, position);
+}
+
+struct candidate
+{                                                                     // A lemma to vivify, ordered by LBD and then by its
+    int lbd, stamp;                                                   // last use
+    ref c;
+};
+
+static int compareCandidates(const void* a, const void* b)
+{
+    const struct candidate *x = (const struct candidate*) a, *y = (const struct candidate*) b;
+    if (x->lbd != y->lbd) return x->lbd - y->lbd;
+    return (x->stamp < y->stamp) - (x->stamp > y->stamp);
+}
+
+template <typename Lit>
+static void detachLemma(struct solver<Lit>* S, ref c)
+{                                                                     // Remove the watches of the lemma at DB[c] (on its
+    for (int k = 0; k < 2; k++)                                       // first two literals)
+    {
+        struct watchList* ws = &S->watches[S->DB[c + k]];
+        for (int i = 0; i < ws->size; i++)
+            if (ws->w[i].cref == c)
+            {
+                ws->w[i] = ws->w[--ws->size];
+                break;
+            }
+    }
+}
+
+template <typename Lit>
+static int vivifyLemma(struct solver<Lit>* S, ref c, int* lits)
+{                                                                     // At the root level, make the literals of the lemma
+    int size = 0, n = 0;                                              // false one at a time and propagate: a conflict or a
+    while (S->DB[c + size]) size++;                                   // true literal ends the lemma early, and literals
+    for (int i = 0; i < size; i++) lits[i] = S->DB[c + i];            // made false by the earlier ones are dropped
+    if (S->fals[-lits[0]] && S->reason[abs(lits[0])] == c) return SAT; // (locked lemmas are skipped)
+    S->probing = true;
+    for (int i = 0; i < size; i++)
+    {
+        int lit = lits[i];
+        if (S->fals[-lit])
+        {                                                             // Implied by the previous literals (or a root unit:
+            lits[n++] = lit;                                          // the lemma is satisfied)
+            break;
+        }
+        if (S->fals[lit]) continue;                                   // Implied false: drop it
+        lits[n++] = lit;
+        decide(S, -lit);
+        int result = propagate(S);
+        if (result == UNKNOWN) break;                                 // A conflict
+        if (result != SAT) return S->probing = false, result;
+    }
+    S->probing = false;
+    restart(S);
+    if (!n) return UNSAT;                                             // Every literal is false at the root level
+    bool satisfied = S->fals[-lits[n - 1]];                           // True at the root level
+    if (!satisfied && n == size)
+    {                                                                 // Nothing to remove: do not try it again
+        setHeader(S->DB + c, LBD_WORD, header(S->DB + c, LBD_WORD) | VIVIFIED);
+        return SAT;
+    }
+    setHeader(S->DB + c, LBD_WORD, header(S->DB + c, LBD_WORD) | REMOVED); // reduceDB drops it
+    detachLemma(S, c);
+    if (satisfied) return SAT;
+    S->vivified++;
+    S->vivifiedLits += size - n;
+    int lbd = header(S->DB + c, LBD_WORD) & ~LEMMA_FLAGS;
+    ref reason = addClause(S, lits, n, 0, lbd < n ? lbd : n);         // (DB may move)
+    if (reason == ERROR) return ERROR;
+    if (n == 1)
+    {                                                                 // A new unit
+        assign(S, lits[0], reason, 1);
+        return propagate(S);
+    }
+    return SAT;
+}
+
+template <typename Lit>
+int vivify(struct solver<Lit>* S)
+{                                                                     // Vivify the tier2 and core lemmas not tried before,
+    double start = wallTime ();                                       // lowest LBD and latest use first, within a share of
+    long long budget = S->nPropagations + (S->nPropagations - S->vivifyProps) * VIVIFY_EFFORT / 100; // the propagations
+    struct candidate* cands = (struct candidate*) malloc (sizeof (struct candidate) * (S->nLemmas + 1));
+    int* lits = (int*) malloc (sizeof (int) * (S->nVars + 1));
+    int n = 0, result = SAT;
+    S->nextVivify = S->nConflicts + VIVIFY_INTERVAL;
+    if (cands && lits)
+    {
+        for (ref c = S->mem_fixed + HEAD<Lit>, next; c < S->mem_used && n <= S->nLemmas; c = next)
+        {
+            int size = 0, word = header(S->DB + c, LBD_WORD);
+            while (S->DB[c + size]) size++;
+            next = c + size + 1 + HEAD<Lit>;
+            if (size > 2 && !(word & (VIVIFIED | REMOVED)) && (word & ~LEMMA_FLAGS) <= TIER2_LBD)
+            {
+                cands[n].lbd = word & ~LEMMA_FLAGS;
+                cands[n].stamp = header(S->DB + c, STAMP_WORD);
+                cands[n++].c = c;
+            }
+        }
+        qsort (cands, n, sizeof (struct candidate), compareCandidates);
+        for (int i = 0; i < n && result == SAT && S->nPropagations < budget; i++)
+            result = vivifyLemma(S, cands[i].c, lits);
+    }
+    free (cands); free (lits);
+    S->nVivify++;
+    S->vivifyProps = S->nPropagations;
+    S->vivifyTime += wallTime () - start;
+    return result;
+}
+
+template <typename Lit>
+static bool outOfBudget(struct solver<Lit>* S, bool clock)
+{                                                                     // Whether solve has to return UNKNOWN: interrupted or
+    return (S->interrupt && S->interrupt->load (std::memory_order_relaxed)) || // a budget is exhausted (the deadline is
+           S->nConflicts >= S->conflictLimit || S->nPropagations >= S->propagationLimit || // checked only with clock)
+           (S->memLimit && S->mem_used > S->memLimit) || (clock && S->deadline > 0 && wallTime () >= S->deadline);
+}
+
+static long long luby(int i)
+{                                                                     // The i-th term (from 0) of 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+    int size = 1, seq = 0;
+    while (size < i + 1) seq++, size = 2 * size + 1;
+    while (size - 1 != i)
+    {
+        size = (size - 1) >> 1;
+        seq--;
+        i = i % size;
+    }
+    return 1LL << seq;
+}
+
+template <typename Lit>
+static bool restartDue(struct solver<Lit>* S)
+{                                                                     // Whether the policy of the current mode restarts after
+    const struct schedule* c = &S->schedule;                          // this conflict
+    int policy = S->stable ? RESTART_LUBY : c->policy;
+    if (policy == RESTART_EMA)
+    {                                                                 // If fast average is substantially larger than slow
+        if (S->fast <= (S->slow / 100) * c->margin) return false;     // average, update the averages
+        S->fast = (S->slow / 100) * c->margin;
+        return true;
+    }
+    double interval = policy == RESTART_GEOMETRIC ? c->unit * pow (c->factor, S->restartSeq) :
+                      (double) luby(S->restartSeq) * (S->stable ? c->stableUnit : c->unit);
+    return S->nConflicts - S->lastRestart >= interval;
+}
+
+template <typename Lit>
+static bool switchDue(struct solver<Lit>* S)
+{                                                                     // Phases alternate focused, stable, focused, ... and the
+    long long length = (long long) S->schedule.modeInterval * (S->nSwitches / 2 + 1); // n-th pair of them lasts
+    return S->schedule.modeInterval > 0 && S->nConflicts - S->modeStart >= length; // n * modeInterval conflicts each
+}
+
+#ifndef MICROSAT_LIBRARY
+static const char* restartNames[] = { "ema", "luby", "geometric" };
+
+template <typename Lit>
+static long long stableConflicts(struct solver<Lit>* S)
+{                                                                     // Conflicts in stable mode, the current phase included
+    return S->stableConflicts + (S->stable ? S->nConflicts - S->modeStart : 0);
+}
+#endif
+
+template <typename Lit>
+static void switchMode(struct solver<Lit>* S)
+{                                                                     // Call at the root level: stable mode decides by EVSIDS
+    if (S->stable) S->stableConflicts += S->nConflicts - S->modeStart; // and restarts rarely, focused mode uses the heuristic
+    S->stable = !S->stable;                                           // and the restart policy of the options
+    S->modeStart = S->nConflicts;
+    S->restartSeq = 0;
+    S->nSwitches++;
+    if (!S->stable)
+    {
+        S->evsids = S->focusEvsids;                                   // The decision list kept its order meanwhile
+        return;
+    }
+    S->focusEvsids = S->evsids;
+    S->evsids = true;
+    for (int v = 1; v <= S->nVars; v++)                               // Without EVSIDS, unassigned variables did not return
+        if (S->heapPos[v] < 0) heapInsert(S, v);                      // to the heap (activities are those of the last
+}                                                                     // stable phase)
+
+template <typename Lit>
+int solve(struct solver<Lit>* S)
+{                                                                     // Determine satisfiability (under S->assumptions);
+    int decision = S->head, ticks = 0;                                // UNKNOWN leaves S ready to be solved further
+    S->assumed = S->failedAssumption = 0;
+    for (;;)
+    {                                                                 // Main solve loop
+        if (S->stop && S->stop->load (std::memory_order_relaxed))
+            return UNKNOWN;                                           // Another thread asked this one to stop
+        if (outOfBudget(S, !(++ticks & DEADLINE_CHECK))) return UNKNOWN;
+        int old_nConflicts = S->nConflicts;                           // Store nConflicts to see whether propagate learns lemmas
+        int result = propagate(S);
+        if (result != SAT) return result;                             // Propagation returns UNSAT for a root level conflict
+        if (S->nConflicts > old_nConflicts)
+        {                                                             // If the last decision caused a conflict
+            decision = S->head;                                       // Reset the decision heuristic to head
+            S->assumed = 0;                                           // The backjump may have undone assumptions
+            if (S->progress > 0 && !(S->nConflicts & PROGRESS_CHECK) && wallTime () >= S->nextProgress)
+                printProgress(S);
+            bool scheduled = restartDue(S), restarting = scheduled;   // The restart policy asks for a restart,
+            bool switching = switchDue(S);                            // or the mode changes (from the root level)
+            if (switching) restarting = true;
+            if (S->share && S->nConflicts >= S->nextImport)
+                restarting = true;                                    // Workers also restart periodically to import lemmas
+            bool walking = S->walk && !S->nAssumptions && S->nConflicts >= S->nextWalk;
+            if (walking) restarting = true;                           // and to run local search from the root
+            if (S->nLemmas > S->maxLemmas)                            // Reduce the DB when it contains too many lemmas (not
+                reduceDB(S);                                          // only at restarts, which the policy may make rare)
+            if (restarting)
+            {
+//				printf("c restarting after ** conflicts (%i %i) %i\n", S->fast, S->slow, S->nLemmas > S->maxLemmas);
+                bool vivifying = S->vivify && S->nConflicts >= S->nextVivify;
+                if (walking || vivifying || switching) restart(S);
+                else restartReuse(S);                                 // Restart
+                S->nRestarts++;
+                S->lastRestart = S->nConflicts;
+                if (S->stable) S->nStableRestarts++;
+                if (scheduled) S->restartSeq++;                       // (the sequence restarts in the next mode)
+                if (switching) switchMode(S);
+                if (vivifying)
+                {                                                     // Shorten the useful lemmas at the root level; its
+                    result = vivify(S);                               // conflicts move variables to the front of the list
+                    if (result != SAT) return result;
+                    decision = S->head;
+                }
+                if (S->share)
+                {                                                     // Import the lemmas of the other workers, and
+                    S->nextImport = S->nConflicts + IMPORT_INTERVAL;  // propagate imported units before deciding
+                    result = importLemmas(S);
+                    if (result != SAT) return result;
+                    continue;
+                }
+            }
+        }
+        if (S->walk && !S->nLevels && !S->nAssumptions && S->nConflicts >= S->nextWalk)
+        {                                                             // Local search sets the phases of the next descent
+            S->nextWalk = S->nConflicts + WALK_INTERVAL * (S->nWalks + 1);
+            walk(S);
+        }
+        int next = 0;
+        while (!next && S->assumed < S->nAssumptions)
+        {                                                             // Decide the assumptions first, in order
+            int lit = S->assumptions[S->assumed++];
+            if (S->fals[lit])
+            {                                                         // Falsified: UNSAT under the assumptions
+                S->failedAssumption = lit;
+                return UNSAT;
+            }
+            if (!S->fals[-lit]) next = lit;                           // Skip assumptions that are already true
+        }
+        if (next)
+        {
+            decide(S, next);
+            continue;
+        }
+        if (S->evsids)
+            do decision = S->heapSize ? heapPop(S) : 0;               // Pop the most active unassigned variable (assigned ones
+            while (S->fals[decision] || S->fals[-decision]);          // return to the heap when they are unassigned)
+        else while (S->fals[decision] || S->fals[-decision])          // As long as the temporay decision is assigned
+            decision = S->prev[decision];                             // Replace it with the next variable in the decision list
+        if (decision == 0) return SAT;                                // If the end of the list is reached, then a solution is found
+        decide(S, S->model[decision] ? decision : -decision);         // Otherwise, assign the decision variable based on the model
+    }
+}
+
+template <typename Lit>
+void freeCDCL(struct solver<Lit>* S)
+{                                                                     // Release the datastructures allocated by initCDCL
+    if (S->watches)
+        for (int i = -S->nVars; i <= S->nVars; i++)
+            free (S->watches[i].w);
+    if (S->bins)
+        for (int i = -S->nVars; i <= S->nVars; i++)
+            free (S->bins[i].lits);
+    if (S->irrBins && !S->sharedBins)
+        for (int i = -S->nVars; i <= S->nVars; i++)
+            free (S->irrBins[i].lits);
+    free (S->DB); free (S->model); free (S->next); free (S->prev);
+    free (S->activity); free (S->heap); free (S->heapPos);
+    free (S->level); free (S->trailLim); free (S->touched); free (S->minStack); free (S->levelStamp);
+    free (S->buffer); free (S->reason); free (S->falseStack);
+    free (S->readPos); free (S->seen);
+    if (S->fals)    free (S->fals    - S->nVars);
+    if (S->watches) free (S->watches - S->nVars);
+    if (S->bins)    free (S->bins    - S->nVars);
+    if (S->irrBins && !S->sharedBins) free (S->irrBins - S->nVars);
+}
+
+template <typename Lit>
+int initCDCL(struct solver<Lit>* S, int n, int m)
+{
+    if (n < 1)      n = 1;                                            // The code assumes that there is at least one variable
+    S->nVars          = n;                                            // Set the number of variables
+    S->nClauses       = m;                                            // Set the number of clauses
+    S->mem_max        = INIT_MEM;                                     // Set the initial maximum memory (DB grows on demand)
+    S->mem_used       = 0;                                            // The number of entries allocated in the DB
+    S->nLemmas        = 0;                                            // The number of learned clauses -- redundant means learned
+    S->nConflicts     = 0;                                            // Number of conflicts used to update scores
+    S->nPropagations  = 0;
+    S->reuse          = true;                                         // Restarts reuse the trail,
+    S->chrono         = 0;                                            // backjumps are never chronological
+    S->nReuses = S->nChrono = 0;
+    S->reusedLits = S->chronoLits = 0;
+    S->walk           = false;                                        // No local search
+    S->nWalks = S->nextWalk = S->walkBest = 0;
+    S->walkFlips      = 0;
+    S->vivify         = false;                                        // No vivification
+    S->probing        = false;
+    S->nVivify = S->nextVivify = 0;
+    S->vivifyProps = S->vivified = S->vivifiedLits = 0;
+    S->vivifyTime     = 0;
+    S->lastReduce     = 0;                                            // Number of conflicts at the previous reduction
+    S->maxLemmas      = 2000;                                         // Initial maximum number of learned clauses
+    S->lemmaInc       = 300;                                          // Growth of maxLemmas at each reduction
+    S->schedule       = DEFAULT_SCHEDULE;                             // EMA restarts in focused mode only
+    S->stable = S->focusEvsids = false;
+    S->nRestarts = S->restartSeq = S->lastRestart = 0;
+    S->nSwitches = S->modeStart = S->nStableRestarts = 0;
+    S->stableConflicts = 0;
+    S->stop           = NULL;                                         // Not cancellable by other threads
+    S->interrupt      = NULL;                                         // nor by the user
+    S->share          = NULL;                                         // No lemma sharing
+    S->proof          = NULL;                                         // and no proof
+    S->readPos        = NULL;
+    S->seen           = NULL;
+    S->nExported = S->nImported = S->nImportUsed = S->nextImport = 0;
+    S->assumptions    = NULL;                                         // No assumptions
+    S->nAssumptions   = S->assumed = S->failedAssumption = 0;
+    S->conflictLimit  = INT_MAX;                                      // and no conflict, propagation or memory budget
+    S->propagationLimit = LLONG_MAX;
+    S->memLimit       = 0;
+    S->deadline       = 0;                                            // or time limit
+    S->progress       = 0;                                            // No progress lines
+    S->nextProgress   = S->startTime = 0;
+    memset (&S->stats, 0, sizeof (S->stats));
+    S->fast = S->slow = 1 << 24;                                      // Initialize the fast and slow moving averages
+    S->evsids         = false;                                        // Move-to-front decisions
+    S->varInc         = 1;
+
+    S->DB = (Lit *) malloc (sizeof (Lit) * (S->mem_max + DB_PAD));    // Allocate the initial database (clauses only)
+    S->model       = (int *) calloc (n+1, sizeof (int));              // Full assignment of the (Boolean) variables (initially set to fals)
+    S->next        = (int *) calloc (n+1, sizeof (int));              // Next variable in the heuristic order
+    S->prev        = (int *) calloc (n+1, sizeof (int));              // Previous variable in the heuristic order
+    S->activity    = (double *) calloc (n+1, sizeof (double));        // EVSIDS activities, all zero
+    S->heap        = (int *) calloc (n+1, sizeof (int));              // and the heap of the variables by activity
+    S->heapPos     = (int *) calloc (n+1, sizeof (int));
+    S->buffer      = (int *) calloc (n+1, sizeof (int));              // A buffer to store a temporary clause
+    S->reason      = (ref *) calloc (n+1, sizeof (ref));              // Array of clauses
+    S->falseStack  = (int *) calloc (n+1, sizeof (int));              // Stack of falsified literals -- this pointer is never changed
+    S->level       = (int *) calloc (n+1, sizeof (int));              // Decision levels (and where they start on falseStack)
+    S->trailLim    = (int *) calloc (n+1, sizeof (int));
+    S->nLevels     = 0;
+    S->touched     = (int *) calloc (n+1, sizeof (int));              // Scratch space of analyze: each variable is touched
+    S->minStack    = (int *) calloc (2*n+2, sizeof (int));            // at most once per conflict, and has at most one frame
+    S->levelStamp  = (int *) calloc (n+1, sizeof (int));
+    S->forced      = S->falseStack;                                   // Points inside *falseStack at first decision (unforced literal)
+    S->processed   = S->falseStack;                                   // Points inside *falseStack at first unprocessed literal
+    S->assigned    = S->falseStack;                                   // Points inside *falseStack at last unprocessed literal
+    S->fals        = (unsigned char *) calloc (2*n+1 + FALS_PAD, 1);  // Labels for variables, non-zero means false
+    S->watches     = (struct watchList*) calloc (2*n+1, sizeof (struct watchList));
+    S->bins        = (struct binList*) calloc (2*n+1, sizeof (struct binList));
+    S->irrBins     = (struct binList*) calloc (2*n+1, sizeof (struct binList));
+    S->sharedBins  = false;
+    if (S->fals)    S->fals    += n;                                  // Literal-indexed arrays are offset by n:
+    if (S->watches) S->watches += n;                                  // empty watch lists for all literals
+    if (S->bins)    S->bins    += n;                                  // and empty implication lists for all literals
+    if (S->irrBins) S->irrBins += n;
+    if (!S->DB || !S->model || !S->next || !S->prev || !S->activity || !S->heap || !S->heapPos || !S->buffer || !S->reason ||
+        !S->falseStack || !S->level || !S->trailLim || !S->touched || !S->minStack || !S->levelStamp ||
+        !S->fals || !S->watches || !S->bins || !S->irrBins)
+    {                                                                 // Report the failure to the caller; S is left empty,
+        freeCDCL(S);                                                  // so that freeing it again is harmless
+        memset (S, 0, sizeof (*S));
+        return ERROR;
+    }
+    S->DB[S->mem_used++] = 0;                                         // Make sure there is a 0 before the clauses are loaded.
+    S->mem_fixed = S->mem_used;                                       // No input clauses in DB yet
+
+    for (int i = 1; i <= n; i++)
+    {                                                                 // Initialize the main datastructures:
+        S->prev[i] = i-1;
+        S->next[i-1] = i;                                             // the double-linked list for variable-move-to-front,
+    }                                                                 // (the model and the fals array are zeroed by calloc)
+	S->head = n;                                                      // Initialize the head of the double-linked list
+    S->heapPos[0] = -1;
+    for (int i = 0; i < n; i++)
+    {                                                                 // With equal activities any order is a heap: take the
+        S->heap[i] = n - i;                                           // variables in the order of the decision list
+        S->heapPos[n - i] = i;
+    }
+    S->heapSize = n;
+    return SAT;
+}
+
+struct arena
+{                                                                     // A clause database kept for the next formula, which
+    void* DB;                                                         // may have literals of another width
+    size_t bytes;                                                     // (padding included)
+};
+
+template <typename Lit>
+static void adoptArena(struct solver<Lit>* S, struct arena* A)
+{                                                                     // Right after initCDCL: take over a larger DB
+    size_t max = A && A->DB ? A->bytes / sizeof (Lit) - DB_PAD : 0;
+    if (max > (size_t) REF_MAX) max = REF_MAX;
+    if (max <= (size_t) S->mem_max) return;
+    free (S->DB);
+    S->DB = (Lit*) A->DB;
+    S->mem_max = (ref) max;
+    S->DB[0] = 0;                                                     // The sentinel before the clauses
+    A->DB = NULL;
+}
+
+template <typename Lit>
+static void keepArena(struct solver<Lit>* S, struct arena* A)
+{                                                                     // Free S but keep its DB in A
+    size_t bytes = sizeof (Lit) * ((size_t) S->mem_max + DB_PAD);
+    if (S->DB && (!A->DB || bytes > A->bytes))
+    {
+        free (A->DB);
+        A->DB = S->DB;
+        A->bytes = bytes;
+        S->DB = NULL;
+    }
+    freeCDCL(S);
+}
+
+template <typename Lit>
+int cloneCDCL(struct solver<Lit>* W, struct solver<Lit>* S)
+{                                                                     // Initialize W with the formula parsed into S
+    if (initCDCL(W, S->nVars, S->nClauses) == ERROR) return ERROR;
+    free (W->irrBins - W->nVars);                                     // The input binaries of S are shared read-only;
+    W->irrBins = S->irrBins;                                          // long input clauses are copied, since propagate
+    W->sharedBins = true;                                             // reorders their literals
+    W->evsids = S->evsids;
+    W->reuse  = S->reuse;
+    W->chrono = S->chrono;
+    W->walk   = S->walk;
+    W->vivify = S->vivify;
+    W->schedule = S->schedule;
+    W->interrupt = S->interrupt;                                      // The budgets hold for each worker
+    W->conflictLimit = S->conflictLimit; W->propagationLimit = S->propagationLimit;
+    W->memLimit = S->memLimit; W->deadline = S->deadline;
+    ref from = W->mem_used;                                           // Both databases start with the same sentinel
+    Lit *DB = getMemory (W, S->mem_fixed - from);
+    if (!DB) return ERROR;
+    memcpy (DB, S->DB + from, sizeof (Lit) * (S->mem_fixed - from));
+    W->mem_fixed = W->mem_used;
+    for (ref c = 1 + HEAD<Lit>, next; c < W->mem_fixed; c = next)
+    {                                                                 // Watch the first two literals of every long clause
+        Lit *clause = W->DB + c;
+        int size = 0;
+        while (clause[size]) size++;
+        next = c + size + 1 + HEAD<Lit>;
+        if (size > 2 && (addWatch (W, clause[0], c, clause[1]) == ERROR ||
+                         addWatch (W, clause[1], c, clause[0]) == ERROR))
+            return ERROR;
+    }
+    for (int *p = S->falseStack; p < S->assigned; p++)
+    {                                                                 // Copy the root level units; those implied by lemmas
+        ref reason = S->reason[abs(*p)];                              // (found by probing) become input units of W
+        int unit = -*p;
+        if (reason >= S->mem_fixed) reason = addClause(W, &unit, 1, 1, 0);
+        if (reason == ERROR) return ERROR;
+        assign(W, -*p, reason, 1);
+    }
+    return SAT;
+}
+
+static void* moveLiteralArray(char* array, void* base, size_t elem, int old, int n)
+{                                                                     // Move an array indexed by literal -old..old into array,
+    memcpy (array + (n - old) * elem, (char*) base - old * elem, (2*old+1) * elem); // allocated for -n..n, and center it
+    free ((char*) base - old * elem);
+    return array + n * elem;
+}
+
+template <typename Lit>
+int growCDCL(struct solver<Lit>* S, int n)
+{                                                                     // Make room for variables up to n between solve calls
+    int old = S->nVars;
+    if (n <= old) return SAT;
+    if (S->sharedBins) return ERROR;                                  // Clones share the input binaries of their parent
+    ref forced = S->forced - S->falseStack, processed = S->processed - S->falseStack, assigned = S->assigned - S->falseStack;
+    int* falseStack = (int*) realloc (S->falseStack, sizeof (int) * (n+1));
+    if (!falseStack) return ERROR;                                    // Each array is replaced once it has grown, so a
+    memset (falseStack + old + 1, 0, sizeof (int) * (n - old));      // failure leaves a consistent solver behind (the
+    S->falseStack = falseStack;                                       // stack is zeroed as propagate peeks one past the top)
+    S->forced     = falseStack + forced;
+    S->processed  = falseStack + processed;
+    S->assigned   = falseStack + assigned;
+    int** vars[] = { &S->model, &S->next, &S->prev, &S->buffer, &S->heap, &S->heapPos,
+                     &S->level, &S->trailLim, &S->touched, &S->levelStamp, &S->minStack };
+    for (int i = 0; i < 11; i++)
+    {                                                                 // (minStack holds two ints per variable)
+        int size = i < 10 ? n+1 : 2*n+2, oldSize = i < 10 ? old+1 : 2*old+2;
+        int* array = (int*) realloc (*vars[i], sizeof (int) * size);
+        if (!array) return ERROR;
+        memset (array + oldSize, 0, sizeof (int) * (size - oldSize));
+        *vars[i] = array;
+    }
+    ref* reason = (ref*) realloc (S->reason, sizeof (ref) * (n+1));
+    if (!reason) return ERROR;
+    S->reason = reason;
+    double* activity = (double*) realloc (S->activity, sizeof (double) * (n+1));
+    if (!activity) return ERROR;
+    memset (activity + old + 1, 0, sizeof (double) * (n - old));
+    S->activity = activity;
+    char* fals    = (char*) calloc (2*n+1 + FALS_PAD, 1);             // The literal-indexed arrays are centered on nVars, so
+    char* watches = (char*) calloc (2*n+1, sizeof (struct watchList)); // they are all allocated before any is replaced
+    char* bins    = (char*) calloc (2*n+1, sizeof (struct binList));
+    char* irrBins = (char*) calloc (2*n+1, sizeof (struct binList));
+    if (!fals || !watches || !bins || !irrBins)
+    {
+        free (fals); free (watches); free (bins); free (irrBins);
+        return ERROR;
+    }
+    S->fals    = (unsigned char*) moveLiteralArray (fals, S->fals, 1, old, n);
+    S->watches = (struct watchList*) moveLiteralArray (watches, S->watches, sizeof (struct watchList), old, n);
+    S->bins    = (struct binList*) moveLiteralArray (bins, S->bins, sizeof (struct binList), old, n);
+    S->irrBins = (struct binList*) moveLiteralArray (irrBins, S->irrBins, sizeof (struct binList), old, n);
+    for (int i = old + 1; i <= n; i++)
+    {                                                                 // New variables go to the front of the decision list
+        S->prev[i] = S->head;
+        S->next[S->head] = i;
+        S->head = i;
+        heapInsert(S, i);                                             // and into the heap
+    }
+    S->nVars = n;
+    return SAT;
+}
+
+static int compareLiterals(const void* a, const void* b)
+{                                                                     // Order by variable, then negative before positive
+    int x = *(const int*) a, y = *(const int*) b;
+    if (abs(x) != abs(y)) return abs(x) - abs(y);
+    return (x > y) - (x < y);
+}
+
+class Solver
+{                                                                     // Incremental interface in the spirit of IPASIR:
+  public:                                                             // lemmas, decision order and phases survive between
+    Solver ()                                                         // solve calls; assumptions hold for one call only
+    {
+        status = initCDCL(&S, 0, 0) == ERROR ? ERROR : SAT;
+        allocated = status == SAT;                                    // initCDCL releases what it allocated on failure
+        searching = resumable = false;
+        assumptions = NULL; nAssumptions = capAssumptions = 0;
+        failedLits = NULL;
+        interrupted = 0;
+        S.interrupt = &interrupted;
+        conflicts = 0; propagations = 0; seconds = 0;
+    }
+
+    ~Solver ()
+    {
+        if (allocated) freeCDCL(&S);
+        free (assumptions);
+        if (failedLits) free (failedLits - S.nVars);
+    }
+
+    int add_clause (const int* lits, int size)
+    {                                                                 // SAT, UNSAT (the formula became unsatisfiable), or ERROR
+        if (status != SAT) return status;
+        backtrackToRoot ();
+        int maxVar = 0, n = 0;
+        for (int i = 0; i < size; i++)
+        {
+            if (!lits[i] || lits[i] == INT_MIN) return ERROR;
+            if (abs(lits[i]) > maxVar) maxVar = abs(lits[i]);
+        }
+        if (growVars (maxVar) == ERROR) return ERROR;
+        int* clause = (int*) malloc (sizeof (int) * (size + 1));
+        if (!clause) return ERROR;
+        memcpy (clause, lits, sizeof (int) * size);
+        qsort (clause, size, sizeof (int), compareLiterals);
+        for (int i = 0; i < size; i++)
+        {                                                             // Drop duplicates and literals false at the root level
+            int lit = clause[i];
+            if (i && lit == clause[i-1]) continue;
+            if (i && lit == -clause[i-1]) { free (clause); return SAT; } // Tautology
+            if (S.fals[-lit]) { free (clause); return SAT; }          // Satisfied at the root level
+            if (!S.fals[lit]) clause[n++] = lit;
+        }
+        if (n == 0) status = UNSAT;
+        else
+        {                                                             // Input clauses added after lemmas were learned are
+            int irr = n == 2 || S.mem_used == S.mem_fixed;            // stored as lemmas with LBD 0, which reduceDB keeps
+            ref reason = addClause(&S, clause, n, irr, 0);
+            if (reason == ERROR) status = ERROR;
+            else if (n == 1) assign(&S, clause[0], reason, 1);        // A unit is forced at the root level
+        }
+        free (clause);
+        return status == ERROR ? ERROR : SAT;
+    }
+
+    void assume (int lit)
+    {                                                                 // Assume lit in the next solve call
+        if (status == ERROR || !lit || lit == INT_MIN) return;
+        if (nAssumptions == capAssumptions)
+        {
+            int cap = capAssumptions ? 2 * capAssumptions : 16;
+            int* array = (int*) realloc (assumptions, sizeof (int) * cap);
+            if (!array) { status = ERROR; return; }
+            assumptions = array; capAssumptions = cap;
+        }
+        assumptions[nAssumptions++] = lit;
+    }
+
+    void set_limits (int conflicts, long long propagations, double seconds, size_t bytes)
+    {                                                                 // Budgets of each later solve call (0: none); bytes
+        this->conflicts    = conflicts > 0 ? conflicts : 0;           // bound the clause database over all calls
+        this->propagations = propagations > 0 ? propagations : 0;
+        this->seconds      = seconds > 0 ? seconds : 0;
+        S.memLimit = (ref) (bytes / sizeof (int) < (size_t) REF_MAX ? bytes / sizeof (int) : REF_MAX);
+    }
+
+    void interrupt ()
+    {                                                                 // Make the running (or else the next) solve call
+        interrupted.store (1);                                        // return UNKNOWN; safe from any thread and from
+    }                                                                 // signal handlers
+
+    int solve ()
+    {                                                                 // SAT, UNSAT (under the assumptions), UNKNOWN (out of
+        int result = status;                                          // budget or interrupted) or ERROR; after UNKNOWN the
+        if (result == SAT) result = growVars (maxAssumption ());      // next call resumes with the lemmas learned so far
+        if (result == SAT)
+        {
+            if (!resumable || nAssumptions) backtrackToRoot ();       // Otherwise continue the interrupted search as is
+            if (failedLits) memset (failedLits - S.nVars, 0, 2*S.nVars+1);
+            S.assumptions  = assumptions;
+            S.nAssumptions = nAssumptions;
+            S.conflictLimit    = conflicts && S.nConflicts < INT_MAX - conflicts ? S.nConflicts + conflicts : INT_MAX;
+            S.propagationLimit = propagations && S.nPropagations < LLONG_MAX - propagations ?
+                                 S.nPropagations + propagations : LLONG_MAX;
+            S.deadline         = seconds ? wallTime () + seconds : 0;
+            result = ::solve(&S);
+            S.nAssumptions = 0;
+            searching = true;                                         // The trail holds the model or the failed assumptions
+            resumable = result == UNKNOWN && !nAssumptions;           // (restarting instead costs many conflicts)
+            if (result == UNSAT && S.failedAssumption) result = analyzeFailed (S.failedAssumption);
+            else if (result == UNSAT || result == ERROR) status = result; // A root level conflict is final
+        }
+        nAssumptions = 0;                                             // Assumptions are cleared by every call
+        interrupted.store (0);                                        // and so is an interrupt
+        return result;
+    }
+
+    int value (int lit) const
+    {                                                                 // After SAT: lit if true, -lit if false, 0 if unknown
+        if (!searching || status != SAT || !lit || abs(lit) > S.nVars) return 0;
+        return S.fals[-lit] ? lit : S.fals[lit] ? -lit : 0;
+    }
+
+    bool failed (int lit) const
+    {                                                                 // After UNSAT: whether assumption lit is part of
+        return failedLits && lit && abs(lit) <= S.nVars && failedLits[lit]; // the reason for it
+    }
+
+    struct solver<int>* core () { return &S; }                        // For statistics and tuning
+
+  private:
+    struct solver<int> S;                                             // (int literals: clauses may add variables at any time)
+    int status;                                                       // SAT while usable, UNSAT or ERROR once final
+    bool allocated, searching;                                        // Whether the trail holds decisions of a solve call
+    bool resumable;                                                   // Whether it holds a search without assumptions that
+                                                                      // ran out of budget (add_clause clears it)
+    int *assumptions, nAssumptions, capAssumptions;
+    char* failedLits;                                                 // Failed assumptions, indexed by literal
+    std::atomic<int> interrupted;
+    int conflicts;                                                    // Budgets per solve call (0: none)
+    long long propagations;
+    double seconds;
+
+    void backtrackToRoot ()
+    {                                                                 // Undo the decisions of the previous call; root level
+        if (searching) restart(&S);                                   // units stay (also the unpropagated ones, which are
+        searching = resumable = false;                                // above S->forced before the first call)
+    }
+
+    int maxAssumption () const
+    {
+        int maxVar = 0;
+        for (int i = 0; i < nAssumptions; i++)
+            if (abs(assumptions[i]) > maxVar) maxVar = abs(assumptions[i]);
+        return maxVar;
+    }
+
+    int growVars (int n)
+    {
+        if (n <= S.nVars) return SAT;
+        int old = S.nVars;
+        if (growCDCL(&S, n) == ERROR) return status = ERROR;
+        if (failedLits) free (failedLits - old);                      // Reallocated (and cleared) by the next analyzeFailed
+        failedLits = NULL;
+        return SAT;
+    }
+
+    int analyzeFailed (int lit)
+    {                                                                 // Collect the assumptions that imply that lit is false:
+        int n = S.nVars;                                              // walk the trail down and expand the reasons of marked
+        if (!failedLits)                                              // variables; every marked decision is an assumption
+        {
+            char* array = (char*) calloc (2*n+1, 1);
+            if (!array) return status = ERROR;
+            failedLits = array + n;
+        }
+        char* marked = (char*) calloc (n+1, 1);
+        if (!marked) return status = ERROR;
+        failedLits[lit] = 1;
+        marked[abs(lit)] = 1;
+        for (int* p = S.assigned; p > S.forced; )
+        {                                                             // Root level literals need no assumptions
+            int v = abs(*(--p));
+            if (!marked[v]) continue;
+            ref reason = S.reason[v];
+            if (!reason) failedLits[-*p] = 1;                         // The decision made -*p true
+            else if (reason < 0) marked[abs(reasonLit(reason))] = 1;
+            else for (int* c = S.DB + reason + 1; *c; c++) marked[abs(*c)] = 1;
+        }
+        free (marked);
+        return UNSAT;
+    }
+};
+
+enum { ELIM_OCCS = 16, ELIM_SIZE = 24, SUBSUME_OCCS = 1000 };        // Limits of variable elimination (occurrences, resolvent
+enum { PROBE_BUDGET = 1 << 24 };                                      // size), subsumption (occurrences of the scanned lists)
+                                                                      // and probing (propagated literals)
+enum { PASS_UNITS, PASS_EQUIV, PASS_SUBSUME, PASS_ELIM, PASS_PROBE, NPASSES };
+static const char* passNames[]   = { "units", "equiv", "subsume", "elim", "probe" };
+static const char* passCounted[] = { "fixed", "substituted", "removed", "eliminated", "failed" };
+
+struct pclause
+{                                                                     // A clause of the preprocessor: lits[start..start+size-1]
+    ref start;
+    int size;
+    unsigned sig;                                                     // One bit per variable (mod 32) for subsumption checks
+    bool deleted;
+};
+
+struct preprocessor
+{                                                                     // Simplifies the input clauses before search
+    int nVars, nClauses, capClauses, *lits, *tmp;
+    ref nLits, capLits;
+    struct pclause* clauses;
+    struct binList* occs;                                             // Clause indices per literal (deleted ones are skipped)
+    signed char* val;                                                 // Root value per literal: 1 true, -1 false, 0 unknown
+    char *mark, *elim;                                                // Scratch marks per literal; removed variables
+    const char* frozen;                                               // Variables that equiv and elim keep (or NULL)
+    int *units, nUnits, qhead;                                        // Root units in order, and the next to propagate
+    int *stack;                                                       // Model reconstruction: clauses stored as their
+    ref nStack, capStack;                                             // literals, size and witness (see extendModel)
+    bool enabled[NPASSES];
+    double time[NPASSES];
+    int count[NPASSES];                                               // Fixed, substituted, removed, eliminated, failed
+    bool quiet;                                                       // Whether to skip the report (batch jobs)
+    struct proof* proof;                                              // Proof of the derived clauses (all RUP), or NULL;
+};                                                                    // removed clauses stay in it
+
+static int preAssign(struct preprocessor* P, int lit)
+{                                                                     // Make lit true at the root level
+    if (P->val[lit] > 0) return SAT;
+    if (P->val[lit] < 0) return UNSAT;
+    P->val[lit] = 1; P->val[-lit] = -1;
+    P->units[P->nUnits++] = lit;
+    return SAT;
+}
+
+template <typename Lit>
+static int preAddClause(struct preprocessor* P, const Lit* in, int size)
+{                                                                     // Add a clause without duplicates; tautologies are
+    if (P->nLits + size > P->capLits)                                 // dropped, units are assigned
+    {
+        ref cap = 2 * P->capLits + size;
+        int* lits = (int*) realloc (P->lits, sizeof (int) * cap);
+        if (!lits) return ERROR;
+        P->lits = lits; P->capLits = cap;
+    }
+    int *clause = P->lits + P->nLits, n = 0;
+    bool tautology = false;
+    for (int i = 0; i < size; i++)
+    {
+        if (P->mark[-in[i]]) tautology = true;
+        if (P->mark[in[i]]) continue;
+        P->mark[in[i]] = 1;
+        clause[n++] = in[i];
+    }
+    for (int i = 0; i < n; i++) P->mark[clause[i]] = 0;
+    if (tautology) return SAT;
+    if (P->proof) proofLine(P->proof, 'a', clause, n);
+    if (n <= 1) return n ? preAssign(P, clause[0]) : UNSAT;
+    if (P->nClauses == P->capClauses)
+    {
+        int cap = P->capClauses ? 2 * P->capClauses : 1024;
+        struct pclause* clauses = (struct pclause*) realloc (P->clauses, sizeof (struct pclause) * cap);
+        if (!clauses) return ERROR;
+        P->clauses = clauses; P->capClauses = cap;
+    }
+    struct pclause* c = &P->clauses[P->nClauses];
+    c->start = P->nLits; c->size = n; c->deleted = false; c->sig = 0;
+    for (int i = 0; i < n; i++)
+    {
+        c->sig |= 1u << (abs(clause[i]) & 31);
+        if (addImplication(P->occs, clause[i], P->nClauses) == ERROR) return ERROR;
+    }
+    P->nLits += n;
+    P->nClauses++;
+    return SAT;
+}
+
+static void removeOcc(struct binList* occ, int c)
+{                                                                     // Remove clause c from an occurrence list
+    for (int i = occ->size - 1; i >= 0; i--)
+        if (occ->lits[i] == c)
+        {
+            occ->lits[i] = occ->lits[--occ->size];
+            return;
+        }
+}
+
+static int preStrengthen(struct preprocessor* P, int c, int lit)
+{                                                                     // Remove lit from clause c
+    struct pclause* C = &P->clauses[c];
+    int* clause = P->lits + C->start;
+    for (int i = 0; i < C->size; i++)
+        if (clause[i] == lit) clause[i] = clause[--C->size];
+    removeOcc(&P->occs[lit], c);
+    C->sig = 0;
+    for (int i = 0; i < C->size; i++) C->sig |= 1u << (abs(clause[i]) & 31);
+    if (P->proof) proofLine(P->proof, 'a', clause, C->size);
+    if (C->size > 1) return SAT;
+    C->deleted = true;                                                // A unit: assign it instead
+    return preAssign(P, clause[0]);
+}
+
+static int prePropagate(struct preprocessor* P)
+{                                                                     // Remove satisfied clauses and false literals of the
+    while (P->qhead < P->nUnits)                                      // units until a fixpoint
+    {
+        int lit = P->units[P->qhead++];
+        for (int i = 0; i < P->occs[lit].size; i++)
+            P->clauses[P->occs[lit].lits[i]].deleted = true;
+        P->occs[lit].size = 0;
+        struct binList* occ = &P->occs[-lit];
+        while (occ->size)
+        {                                                             // preStrengthen removes the last entry
+            int c = occ->lits[occ->size - 1];
+            if (P->clauses[c].deleted) occ->size--;
+            else if (preStrengthen(P, c, -lit) == UNSAT) return UNSAT;
+        }
+    }
+    return SAT;
+}
+
+static int pushWitness(struct preprocessor* P, const int* lits, int size, int witness)
+{                                                                     // Save a removed clause for extendModel
+    if (P->nStack + size + 2 > P->capStack)
+    {
+        ref cap = 2 * P->capStack + size + 2;
+        int* stack = (int*) realloc (P->stack, sizeof (int) * cap);
+        if (!stack) return ERROR;
+        P->stack = stack; P->capStack = cap;
+    }
+    memcpy (P->stack + P->nStack, lits, sizeof (int) * size);
+    P->nStack += size;
+    P->stack[P->nStack++] = size;
+    P->stack[P->nStack++] = witness;
+    return SAT;
+}
+
+void extendModel(struct preprocessor* P, int* model)
+{                                                                     // Give removed variables values: going back from the
+    for (ref i = P->nStack; i > 0; )                                  // last removal, make the witness true in every saved
+    {                                                                 // clause that the model falsifies
+        int witness = P->stack[--i], size = P->stack[--i];
+        i -= size;
+        bool satisfied = false;
+        for (int j = 0; j < size && !satisfied; j++)
+        {
+            int lit = P->stack[i + j];
+            satisfied = model[abs(lit)] == (lit > 0);
+        }
+        if (!satisfied) model[abs(witness)] = witness > 0;
+    }
+}
+
+static int equivPass(struct preprocessor* P)
+{                                                                     // Substitute equivalent literals: the strongly connected
+    int n = P->nVars, counter = 0, nStk = 0, nFrames = 0, result = SAT; // components of the binary implication graph (Tarjan,
+    int *index = (int*) calloc (2*n+1, sizeof (int));                 // iteratively) are replaced by their literal of the
+    int *low   = (int*) calloc (2*n+1, sizeof (int));                 // smallest variable
+    int *repr  = (int*) calloc (2*n+1, sizeof (int));
+    int *stk   = (int*) malloc (sizeof (int) * (2*n+1));
+    int *frame = (int*) malloc (sizeof (int) * (2*n+1)), *pos = (int*) malloc (sizeof (int) * (2*n+1));
+    if (!index || !low || !repr || !stk || !frame || !pos)
+    {
+        free (index); free (low); free (repr); free (stk); free (frame); free (pos);
+        return ERROR;
+    }
+    index += n; low += n; repr += n;                                  // Indexed by literal
+    for (int s = -n; s <= n && result == SAT; s++)
+    {
+        if (!s || index[s] || P->val[s] || P->elim[abs(s)]) continue;
+        index[s] = low[s] = ++counter; stk[nStk++] = s; P->mark[s] = 1;
+        frame[nFrames] = s; pos[nFrames++] = 0;
+        while (nFrames && result == SAT)
+        {
+            int u = frame[nFrames - 1], next = 0;
+            struct binList* occ = &P->occs[-u];                       // u implies the other literal of each binary with -u
+            while (!next && pos[nFrames - 1] < occ->size)
+            {
+                struct pclause* C = &P->clauses[occ->lits[pos[nFrames - 1]++]];
+                if (C->deleted || C->size != 2) continue;
+                int b = P->lits[C->start] == -u ? P->lits[C->start + 1] : P->lits[C->start];
+                if (P->val[b] || P->elim[abs(b)]) continue;
+                if (!index[b]) next = b;
+                else if (P->mark[b] && index[b] < low[u]) low[u] = index[b];
+            }
+            if (next)
+            {                                                         // Descend into b
+                index[next] = low[next] = ++counter; stk[nStk++] = next; P->mark[next] = 1;
+                frame[nFrames] = next; pos[nFrames++] = 0;
+                continue;
+            }
+            nFrames--;
+            if (nFrames && low[u] < low[frame[nFrames - 1]]) low[frame[nFrames - 1]] = low[u];
+            if (low[u] != index[u]) continue;
+            int first = nStk, r = u;                                  // u is the root of a component; its representative is
+            do                                                        // a frozen literal if it has one (frozen ones stay)
+            {
+                first--;
+                bool frozen = P->frozen && P->frozen[abs(stk[first])], rFrozen = P->frozen && P->frozen[abs(r)];
+                if (frozen > rFrozen || (frozen == rFrozen && abs(stk[first]) < abs(r))) r = stk[first];
+            } while (stk[first] != u);
+            for (int i = first; i < nStk; i++)
+            {                                                         // Popped literals are never compared again, so low
+                P->mark[stk[i]] = 0;                                  // now tags the component (by the negated index of u)
+                low[stk[i]] = -index[u];
+                if (stk[i] != r && !(P->frozen && P->frozen[abs(stk[i])])) repr[stk[i]] = r;
+            }
+            for (int i = first; i < nStk && result == SAT; i++)
+                if (low[-stk[i]] == -index[u])
+                {                                                     // A literal equivalent to its complement: its
+                    int unit = -stk[i];                               // negation is RUP (before the empty clause)
+                    if (P->proof) proofLine(P->proof, 'a', &unit, 1);
+                    result = UNSAT;
+                }
+            nStk = first;
+        }
+    }
+    int nClauses = P->nClauses;
+    for (int v = 1; v <= n && result == SAT; v++)
+        if (repr[v])
+        {                                                             // v = repr[v]: save both directions for extendModel
+            int eq[2] = { v, -repr[v] };
+            if (pushWitness(P, eq, 2, v) == ERROR) result = ERROR;
+            eq[0] = -v; eq[1] = repr[v];
+            if (pushWitness(P, eq, 2, -v) == ERROR) result = ERROR;
+            P->elim[v] = 1;
+            P->count[PASS_EQUIV]++;
+        }
+    for (int c = 0; c < nClauses && result == SAT; c++)
+    {                                                                 // Rewrite the clauses with substituted literals
+        struct pclause* C = &P->clauses[c];
+        if (C->deleted) continue;
+        bool changed = false;
+        for (int i = 0; i < C->size; i++)
+            changed |= repr[P->lits[C->start + i]] != 0;
+        if (!changed) continue;
+        for (int i = 0; i < C->size; i++)
+        {
+            int lit = P->lits[C->start + i];
+            P->tmp[i] = repr[lit] ? repr[lit] : lit;
+        }
+        C->deleted = true;
+        result = preAddClause(P, P->tmp, C->size);
+    }
+    if (result == SAT) result = prePropagate(P);
+    free (index - n); free (low - n); free (repr - n);
+    free (stk); free (frame); free (pos);
+    return result;
+}
+
+static int compareKeys(const void* a, const void* b)
+{
+    long long x = *(const long long*) a, y = *(const long long*) b;
+    return (x > y) - (x < y);
+}
+
+static int subsumePass(struct preprocessor* P)
+{                                                                     // Remove subsumed clauses and strengthen clauses by
+    int nClauses = P->nClauses, nKeys = 0;                            // self-subsuming resolution, shortest clauses first
+    long long* keys = (long long*) malloc (sizeof (long long) * (nClauses + 1));
+    int* strengthen = (int*) malloc (sizeof (int) * 2 * (nClauses + 1));
+    if (!keys || !strengthen)
+    {
+        free (keys); free (strengthen);
+        return ERROR;
+    }
+    for (int c = 0; c < nClauses; c++)
+        if (!P->clauses[c].deleted) keys[nKeys++] = ((long long) P->clauses[c].size << 32) | c;
+    qsort (keys, nKeys, sizeof (long long), compareKeys);
+    int result = SAT;
+    for (int k = 0; k < nKeys && result == SAT; k++)
+    {
+        int c = (int) (keys[k] & 0xffffffff);
+        struct pclause C = P->clauses[c];
+        if (C.deleted) continue;
+        int *clause = P->lits + C.start, x = clause[0], nStrengthen = 0;
+        for (int i = 0; i < C.size; i++)
+        {                                                             // Scan the occurrences of the rarest variable
+            P->mark[clause[i]] = 1;
+            if (P->occs[clause[i]].size + P->occs[-clause[i]].size < P->occs[x].size + P->occs[-x].size)
+                x = clause[i];
+        }
+        if (P->occs[x].size + P->occs[-x].size <= SUBSUME_OCCS)
+            for (int side = 0; side < 2; side++)
+            {
+                struct binList* occ = &P->occs[side ? -x : x];
+                for (int i = 0; i < occ->size; i++)
+                {
+                    int d = occ->lits[i];
+                    struct pclause* D = &P->clauses[d];
+                    if (d == c || D->deleted || D->size < C.size || (C.sig & ~D->sig)) continue;
+                    int matched = 0, flipped = 0, flip = 0;
+                    for (int j = 0; j < D->size; j++)
+                    {
+                        int lit = P->lits[D->start + j];
+                        if (P->mark[lit]) matched++;
+                        else if (P->mark[-lit]) flipped++, flip = lit;
+                    }
+                    if (matched == C.size)
+                    {                                                 // C subsumes D
+                        D->deleted = true;
+                        P->count[PASS_SUBSUME]++;
+                    }
+                    else if (matched == C.size - 1 && flipped == 1)
+                    {                                                 // Resolving D with C on flip yields D without flip
+                        strengthen[nStrengthen++] = d;
+                        strengthen[nStrengthen++] = flip;
+                    }
+                }
+            }
+        for (int i = 0; i < C.size; i++) P->mark[clause[i]] = 0;
+        for (int i = 0; i < nStrengthen && result == SAT; i += 2)
+            if (!P->clauses[strengthen[i]].deleted)
+                result = preStrengthen(P, strengthen[i], strengthen[i+1]);
+        if (result == SAT) result = prePropagate(P);
+    }
+    free (keys); free (strengthen);
+    return result;
+}
+
+static int resolve(struct preprocessor* P, int c, int d, int v)
+{                                                                     // Resolvent of c and d on v in P->tmp: its size, or -1
+    struct pclause *C = &P->clauses[c], *D = &P->clauses[d];          // for a tautology
+    int n = 0, result;
+    for (int i = 0; i < C->size; i++)
+    {
+        int lit = P->lits[C->start + i];
+        if (lit != v) P->mark[lit] = 1, P->tmp[n++] = lit;
+    }
+    bool tautology = false;
+    for (int i = 0; i < D->size && !tautology; i++)
+    {
+        int lit = P->lits[D->start + i];
+        if (lit == -v || P->mark[lit]) continue;
+        if (P->mark[-lit]) tautology = true;
+        else P->tmp[n++] = lit;
+    }
+    for (int i = 0; i < C->size; i++) P->mark[P->lits[C->start + i]] = 0;
+    result = tautology ? -1 : n;
+    return result;
+}
+
+static int liveOccs(struct preprocessor* P, int lit)
+{                                                                     // Drop deleted clauses from the occurrences of lit
+    struct binList* occ = &P->occs[lit];
+    int j = 0;
+    for (int i = 0; i < occ->size; i++)
+        if (!P->clauses[occ->lits[i]].deleted) occ->lits[j++] = occ->lits[i];
+    return occ->size = j;
+}
+
+static int elimPass(struct preprocessor* P)
+{                                                                     // Bounded variable elimination: replace the clauses of
+    int n = P->nVars, nKeys = 0, result = SAT;                        // a variable by their resolvents if that does not
+    long long* keys = (long long*) malloc (sizeof (long long) * (n + 1)); // add clauses, cheapest variables first
+    if (!keys) return ERROR;
+    for (int v = 1; v <= n; v++)
+    {
+        if (P->val[v] || P->elim[v] || (P->frozen && P->frozen[v])) continue;
+        int occs = liveOccs(P, v) + liveOccs(P, -v);
+        if (occs <= ELIM_OCCS) keys[nKeys++] = ((long long) occs << 32) | v;
+    }
+    qsort (keys, nKeys, sizeof (long long), compareKeys);
+    for (int k = 0; k < nKeys && result == SAT; k++)
+    {
+        int v = (int) (keys[k] & 0xffffffff);
+        if (P->val[v]) continue;
+        int pos = liveOccs(P, v), neg = liveOccs(P, -v), nResolvents = 0;
+        if (pos + neg > ELIM_OCCS) continue;
+        bool bounded = true;
+        for (int i = 0; i < pos && bounded; i++)
+            for (int j = 0; j < neg && bounded; j++)
+            {
+                int size = resolve(P, P->occs[v].lits[i], P->occs[-v].lits[j], v);
+                if (size > ELIM_SIZE || (size >= 0 && ++nResolvents > pos + neg)) bounded = false;
+            }
+        if (!bounded) continue;
+        for (int i = 0; i < pos && result == SAT; i++)
+            for (int j = 0; j < neg && result == SAT; j++)
+            {                                                         // Resolvents do not contain v, so the occurrence
+                int size = resolve(P, P->occs[v].lits[i], P->occs[-v].lits[j], v); // lists of v stay intact
+                if (size >= 0) result = preAddClause(P, P->tmp, size);
+            }
+        for (int side = 0; side < 2 && result == SAT; side++)
+        {                                                             // Save the clauses of v with v as their witness
+            int lit = side ? -v : v;
+            for (int i = 0; i < P->occs[lit].size && result == SAT; i++)
+            {
+                struct pclause* C = &P->clauses[P->occs[lit].lits[i]];
+                C->deleted = true;
+                result = pushWitness(P, P->lits + C->start, C->size, lit);
+            }
+            P->occs[lit].size = 0;
+        }
+        P->elim[v] = 1;
+        P->count[PASS_ELIM]++;
+        if (result == SAT) result = prePropagate(P);
+    }
+    free (keys);
+    return result;
+}
+
+template <typename Lit>
+static int probePass(struct solver<Lit>* S, int* nFailed)
+{                                                                     // Failed literal probing on the solver: a literal whose
+    int result = propagate(S);                                        // propagation conflicts yields a unit lemma (the
+    if (result != SAT) return result;                                 // first UIP of the only decision level)
+    long long budget = PROBE_BUDGET;
+    for (int v = 1; v <= S->nVars && budget > 0; v++)
+        for (int sign = 0; sign < 2; sign++)
+        {                                                             // Probe the literals with binary implications
+            int lit = sign ? -v : v, old_nConflicts = S->nConflicts, *base = S->assigned;
+            if (S->fals[lit] || S->fals[-lit] || !S->irrBins[-lit].size) continue;
+            decide(S, lit);
+            result = propagate(S);
+            if (result != SAT) return result;
+            if (S->nConflicts > old_nConflicts) (*nFailed)++;
+            budget -= S->assigned - base;
+            restart(S);
+        }
+    return SAT;
+}
+
+template <typename Lit>
+static int preLoad(struct preprocessor* P, struct solver<Lit>* S)
+{                                                                     // Collect the input clauses and units of S
+    for (ref c = 1 + HEAD<Lit>, next; c < S->mem_fixed; c = next)
+    {
+        int size = 0;
+        while (S->DB[c + size]) size++;
+        next = c + size + 1 + HEAD<Lit>;
+        int result = size > 1 ? preAddClause(P, S->DB + c, size) : SAT;
+        if (result != SAT) return result;
+    }
+    for (int lit = -S->nVars; lit <= S->nVars; lit++)
+        for (int i = 0; i < S->irrBins[lit].size; i++)
+        {                                                             // Each binary is in the lists of both its literals
+            int bin[2] = { lit, S->irrBins[lit].lits[i] };
+            int result = lit <= bin[1] ? preAddClause(P, bin, 2) : SAT;
+            if (result != SAT) return result;
+        }
+    for (int* p = S->falseStack; p < S->assigned; p++)
+        if (preAssign(P, -*p) == UNSAT) return UNSAT;
+    return SAT;
+}
+
+template <typename Lit>
+static int preStore(struct preprocessor* P, struct solver<Lit>* S)
+{                                                                     // Rebuild S from the simplified clauses
+    int n = S->nVars, nClauses = 0;
+    for (int c = 0; c < P->nClauses; c++) nClauses += !P->clauses[c].deleted;
+    struct arena A = { NULL, 0 };
+    keepArena(S, &A);                                                 // The simplified clauses fit in the DB of the input
+    if (initCDCL(S, n, nClauses + P->nUnits) == ERROR)
+    {
+        free (A.DB);
+        return ERROR;
+    }
+    adoptArena(S, &A);
+    free (A.DB);                                                      // (NULL if adopted)
+    for (int c = 0; c < P->nClauses; c++)
+        if (!P->clauses[c].deleted && addClause(S, P->lits + P->clauses[c].start, P->clauses[c].size, 1, 0) == ERROR)
+            return ERROR;
+    for (int i = 0; i < P->nUnits; i++)
+    {
+        ref reason = addClause(S, &P->units[i], 1, 1, 0);
+        if (reason == ERROR) return ERROR;
+        assign(S, P->units[i], reason, 1);
+    }
+    return SAT;
+}
+
+static void freePreprocessor(struct preprocessor* P, bool all)
+{                                                                     // The reconstruction stack outlives the other parts
+    if (P->occs)
+    {
+        for (int i = -P->nVars; i <= P->nVars; i++) free (P->occs[i].lits);
+        free (P->occs - P->nVars);
+    }
+    if (P->val)  free (P->val - P->nVars);
+    if (P->mark) free (P->mark - P->nVars);
+    free (P->lits); free (P->clauses); free (P->tmp); free (P->elim); free (P->units);
+    P->occs = NULL; P->val = NULL; P->mark = NULL; P->lits = NULL; P->clauses = NULL;
+    P->tmp = NULL; P->elim = NULL; P->units = NULL;
+    if (all) free (P->stack), P->stack = NULL, P->nStack = 0;
+}
+
+template <typename Lit>
+int preprocess(struct solver<Lit>* S, struct preprocessor* P)
+{                                                                     // Simplify the formula parsed into S with the enabled
+    int n = S->nVars, nClauses = S->nClauses, result = SAT;           // passes (P->enabled), timing each of them
+    memset (P->time, 0, sizeof (P->time));
+    memset (P->count, 0, sizeof (P->count));
+    P->nVars = n; P->nClauses = P->capClauses = P->nUnits = P->qhead = 0;
+    P->nLits = P->capLits = P->nStack = P->capStack = 0;
+    P->lits = NULL; P->clauses = NULL; P->stack = NULL;
+    P->occs  = (struct binList*) calloc (2*n+1, sizeof (struct binList));
+    P->val   = (signed char*) calloc (2*n+1, 1);
+    P->mark  = (char*) calloc (2*n+1, 1);
+    P->elim  = (char*) calloc (n+1, 1);
+    P->tmp   = (int*) malloc (sizeof (int) * (n+1));
+    P->units = (int*) malloc (sizeof (int) * (n+1));
+    if (P->occs) P->occs += n;
+    if (P->val)  P->val  += n;
+    if (P->mark) P->mark += n;
+    if (!P->occs || !P->val || !P->mark || !P->elim || !P->tmp || !P->units) result = ERROR;
+    if (result == SAT) result = preLoad(P, S);
+    P->proof = S->proof;                                              // Log the clauses derived from the input ones
+    if (!P->enabled[PASS_UNITS]) P->qhead = P->nUnits;                // Leave the input units to the solver
+    int (*passes[])(struct preprocessor*) = { prePropagate, equivPass, subsumePass, elimPass };
+    for (int i = PASS_UNITS; i <= PASS_ELIM && result == SAT; i++)
+        if (P->enabled[i])
+        {
+            double start = wallTime ();
+            int units = P->nUnits;
+            result = passes[i](P);
+            if (i == PASS_UNITS) P->count[i] = P->nUnits;
+            else P->count[PASS_UNITS] += P->nUnits - units;
+            P->time[i] = wallTime () - start;
+        }
+    if (result == SAT)
+    {
+        int nVars = 0;
+        for (int v = 1; v <= n; v++) nVars += !P->val[v] && !P->elim[v];
+        result = preStore(P, S);
+        S->proof = P->proof;                                          // (initCDCL cleared it)
+        if (!P->quiet)
+            printf("c preprocessing: %i vars %i clauses -> %i vars %i clauses\n", n, nClauses, nVars, S->nClauses - P->nUnits);
+    }
+    freePreprocessor(P, result != SAT);
+    if (result == SAT && P->enabled[PASS_PROBE])
+    {
+        double start = wallTime ();
+        result = probePass(S, &P->count[PASS_PROBE]);
+        P->time[PASS_PROBE] = wallTime () - start;
+    }
+    for (int i = 0; i < NPASSES && !P->quiet; i++)
+        if (P->enabled[i])
+            printf("c   %-8s %6.2f s  %i %s\n", passNames[i], P->time[i], P->count[i], passCounted[i]);
+    return result;
+}
+
+template <typename Lit>
+static int blockModel(struct solver<Lit>* S, const int* project, int nProject)
+{                                                                     // Exclude the projection of the current model by a
+    int size = 0, n = 0, nTouched = 0;                                // clause of its negated literals, without those that
+    unsigned levels = 0;                                              // the others imply (as in analyze); backtrack only
+    for (int i = 0; i < nProject; i++)                                // until the clause is no longer false
+    {
+        int v = project[i], lit = S->fals[v] ? v : -v;                // The false literal of v
+        if (!S->level[v]) continue;                                   // Root level values are the same in every model
+        S->fals[lit] = MARK;
+        S->touched[nTouched++] = lit;
+        S->buffer[size++] = lit;
+        levels |= levelBit(S, lit);
+    }
+    for (int i = 0; i < size; i++)
+    {
+        int lit = S->buffer[i];
+        if (S->reason[abs(lit)] && implied(S, lit, levels, &nTouched)) continue;
+        S->buffer[n++] = lit;
+    }
+    for (int i = 0; i < nTouched; i++)
+        S->fals[S->touched[i]] = 1;
+    if (!n) return UNSAT;                                             // The only projection is enumerated
+    for (int k = 0; k < 2 && k < n; k++)
+        for (int i = k + 1; i < n; i++)
+            if (S->level[abs(S->buffer[i])] > S->level[abs(S->buffer[k])])
+            {                                                         // The literals of the two highest levels go to the
+                int lit = S->buffer[k];                               // front, where they are watched
+                S->buffer[k] = S->buffer[i];
+                S->buffer[i] = lit;
+            }
+    int top = S->level[abs(S->buffer[0])];
+    bool unit = n == 1 || S->level[abs(S->buffer[1])] < top;          // Otherwise two literals of level top become unassigned
+    backtrack(S, S->falseStack + S->trailLim[n == 1 ? 0 : top - 1]);
+    int irr = n == 2 || S->mem_used == S->mem_fixed;                  // Stored like the clauses of Solver::add_clause
+    ref reason = addClause(S, S->buffer, n, irr, 0);
+    if (reason == ERROR) return ERROR;
+    if (unit) assign(S, S->buffer[0], reason, !S->nLevels);           // Asserted one level below top (as with --chrono)
+    return SAT;
+}
+
+template <typename Lit>
+int enumerate(struct solver<Lit>* S, const int* project, int nProject, long long maxModels, long long* nModels, FILE* out)
+{                                                                     // Write the models projected on project to out, one
+    char* line = (char*) malloc (12 * (size_t) nProject + 4);         // "v" line each, flushed as soon as it is found; UNSAT
+    if (!line) return ERROR;                                          // once all are written, SAT at maxModels (0: none)
+    int result;
+    while ((result = solve(S)) == SAT)
+    {                                                                 // Learned clauses, phases and the trail below the
+        char* p = line;                                               // blocked levels carry over to the next model
+        *p++ = 'v';
+        for (int i = 0; i < nProject; i++)
+        {
+            int lit = S->fals[project[i]] ? -project[i] : project[i];
+            char digits[12], *d = digits;
+            *p++ = ' ';
+            if (lit < 0) *p++ = '-', lit = -lit;
+            do *d++ = '0' + lit % 10; while (lit /= 10);
+            while (d > digits) *p++ = *--d;
+        }
+        memcpy (p, " 0\n", 3);
+        fwrite (line, 1, p + 3 - line, out);
+        fflush (out);
+        if (++*nModels == maxModels) break;
+        if ((result = blockModel(S, project, nProject)) != SAT) break;
+        if (outOfBudget(S, true))
+        {                                                             // solve may find each model before it looks at the
+            result = UNKNOWN;                                         // clock (every DEADLINE_CHECK iterations)
+            break;
+        }
+    }
+    free (line);
+    return result;
+}
+
+#ifndef MICROSAT_LIBRARY
+static int readProjection(const char* list, int nVars, char* frozen, int* project)
+{                                                                     // Parse variables and ranges such as "1-10,15" into
+    int n = 0;                                                        // project (without duplicates) and freeze them
+    while (*list)
+    {
+        char* end;
+        long from = strtol (list, &end, 10), to = from;
+        if (end == list) return ERROR;
+        if (*end == '-') to = strtol (list = end + 1, &end, 10);
+        if (end == list || from < 1 || to < from || to > nVars || (*end && *end != ',')) return ERROR;
+        for (long v = from; v <= to; v++)
+            if (!frozen[v]) frozen[v] = 1, project[n++] = (int) v;
+        list = *end ? end + 1 : end;
+    }
+    return n;
+}
+#endif
+
+struct config
+{                                                                     // Parameters that diversify portfolio workers
+    int margin, maxLemmas, lemmaInc, order;                           // order: 0 default, 1 reversed, 2 random
+    unsigned seed;                                                    // Seed of the random phases and order (0: none)
+};
+
+static const char* orderNames[] = { "default", "reversed", "random" };
+
+struct config portfolioConfig(int id)
+{                                                                     // Worker 0 runs the default configuration
+    static const int margins[] = { 125, 115, 140, 120, 110, 133, 150, 105 };
+    static const int lemmas [] = { 2000, 1000, 4000, 3000, 1500, 6000 };
+    static const int incs   [] = { 300, 150, 600, 450 };
+    struct config c = { margins[id % 8], lemmas[id % 6], incs[id % 4], id % 3, (unsigned) id };
+    return c;
+}
+
+template <typename Lit>
+void applyConfig(struct solver<Lit>* S, const struct config* c)
+{
+    S->schedule.margin = c->margin;
+    S->maxLemmas = c->maxLemmas;
+    S->lemmaInc  = c->lemmaInc;
+    unsigned state = c->seed * 2654435761u + 1;
+    int n = S->nVars, *perm = S->buffer;                              // The buffer is free before solving
+    for (int i = 0; i < n; i++)
+        perm[i] = c->order == 1 ? n - i : i + 1;                      // Variables from the tail to the head of the list
+    if (c->order == 2)
+        for (int i = n - 1; i > 0; i--)
+        {                                                             // Fisher-Yates shuffle
+            int j = nextRandom(&state) % (i + 1), tmp = perm[i];
+            perm[i] = perm[j];
+            perm[j] = tmp;
+        }
+    for (int i = 0; i < n; i++)
+    {                                                                 // Rebuild the double-linked decision list
+        S->prev[perm[i]] = i ? perm[i-1] : 0;
+        S->next[S->prev[perm[i]]] = perm[i];
+    }
+    S->head = perm[n-1];
+    S->heapSize = 0;
+    for (int i = n - 1; i >= 0; i--)
+    {                                                                 // Same initial order for EVSIDS, by activities below
+        S->activity[perm[i]] = (double) (i + 1) / n;                  // a single bump
+        heapInsert(S, perm[i]);
+    }
+    if (c->seed)
+        for (int i = 1; i <= n; i++)
+            if (!S->fals[i] && !S->fals[-i])
+                S->model[i] = nextRandom(&state) & 1;                 // Random initial phases
+}
+
+template <typename Lit>
+struct worker
+{                                                                     // A portfolio thread and its solver
+    struct solver<Lit>* S;
+    struct config config;
+    std::atomic<int> *stop, *winner;
+    pthread_t thread;
+    int id, result;
+    bool running;
+};
+
+template <typename Lit>
+static void* runWorker(void* arg)
+{
+    struct worker<Lit>* w = (struct worker<Lit>*) arg;
+    w->result = solve(w->S);
+    int none = -1;
+    if ((w->result == SAT || w->result == UNSAT) && w->winner->compare_exchange_strong(none, w->id))
+        w->stop->store(1);                                            // The first finisher cancels the others
+    return NULL;
+}
+
+template <typename Lit>
+int solvePortfolio(struct solver<Lit>* S, int nThreads, int shareSize, int shareLbd, struct solver<Lit>** won)
+{                                                                     // Race nThreads diversified solvers on the formula in S
+    std::atomic<int> stop(0), winner(-1);
+    struct worker<Lit>* workers = (struct worker<Lit>*) calloc (nThreads, sizeof (struct worker<Lit>));
+    struct solver<Lit>* clones = (struct solver<Lit>*) calloc (nThreads, sizeof (struct solver<Lit>));
+    struct sharing share = { NULL, nThreads, shareSize < SHARE_MAX ? shareSize : SHARE_MAX, shareLbd };
+    if (shareSize > 0)                                                // Export rings (all heads and seqs start at 0)
+        share.rings = (struct shareRing*) calloc (nThreads, sizeof (struct shareRing));
+    if (!workers || !clones || (shareSize > 0 && !share.rings))
+    {
+        free (workers); free (clones); free (share.rings);
+        return ERROR;
+    }
+    int started = 0;
+    for (int i = 0; i < nThreads; i++)
+    {                                                                 // Worker 0 solves S itself; clone S before it starts
+        struct worker<Lit>* w = &workers[i];
+        w->S = i ? &clones[i] : S;
+        if (i && cloneCDCL(w->S, S) == ERROR)
+        {
+            freeCDCL(w->S);
+            break;
+        }
+        w->id = i; w->stop = &stop; w->winner = &winner;
+        w->config = portfolioConfig(i);
+        applyConfig(w->S, &w->config);
+        w->S->stop = &stop;
+        if (share.rings)
+        {                                                             // Join the lemma exchange
+            w->S->share   = &share;
+            w->S->shareId = i;
+            w->S->readPos = (unsigned*) calloc (nThreads, sizeof (unsigned));
+            w->S->seen    = (unsigned long long*) calloc (SEEN_SIZE, sizeof (unsigned long long));
+            if (!w->S->readPos || !w->S->seen) w->S->share = NULL;    // Solve without sharing instead
+        }
+        started++;
+    }
+    int running = 0;
+    for (int i = 0; i < started; i++)
+        if (!pthread_create (&workers[i].thread, NULL, runWorker<Lit>, &workers[i]))
+            workers[i].running = true, running++;
+    if (!running) runWorker<Lit>(&workers[0]);                        // Without threads, solve the default inline
+    for (int i = 0; i < started; i++)
+        if (workers[i].running) pthread_join (workers[i].thread, NULL);
+    int id = winner.load();
+    if (id < 0 && workers[0].result == UNKNOWN) id = 0;               // Out of budget (or interrupted): report S itself
+    if (share.rings)
+        for (int i = 0; i < started; i++)
+        {
+            struct solver<Lit>* W = workers[i].S;
+            printf("c sharing: worker %i exported %i imported %i used %i\n", i, W->nExported, W->nImported, W->nImportUsed);
+            W->share = NULL;                                          // The rings are released below,
+            free (W->readPos); free (W->seen);                        // the read positions and filters here
+            W->readPos = NULL; W->seen = NULL;
+        }
+    free (share.rings);
+    S->stop = NULL;                                                   // (stop lives on this stack frame)
+    for (int i = 1; i < started; i++)
+        if (i != id) freeCDCL(workers[i].S);                          // Keep only the winner alive for its statistics
+    int result = id < 0 ? ERROR : workers[id].result;                 // ERROR: every worker ran out of memory
+    *won = S;
+    if (result != ERROR && result != UNKNOWN)
+    {
+        struct config* c = &workers[id].config;
+        printf("c portfolio: worker %i of %i won (restart margin %i%%, max_lemmas %i +%i, %s order, phase seed %u)\n",
+               id, nThreads, c->margin, c->maxLemmas, c->lemmaInc, orderNames[c->order], c->seed);
+        *won = workers[id].S;
+        workers[id].S->stop = NULL;
+    }
+    if (id <= 0) free (clones);                                       // (a winning clone stays allocated, like S)
+    free (workers);
+    return result;
+}
+
+enum { LOOKAHEAD_VARS = 32 };                                         // Candidates probed per split by the cuber
+
+template <typename Lit>
+static int probe(struct solver<Lit>* S, int lit)
+{                                                                     // Decide lit and propagate: the number of implied
+    int* base = S->assigned;                                          // literals, or -1 after a conflict (which is
+    int old_nConflicts = S->nConflicts;                               // analyzed and leaves the trail backjumped)
+    decide(S, lit);
+    if (propagate(S) != SAT || S->nConflicts > old_nConflicts) return -1;
+    return S->assigned - base;
+}
+
+template <typename Lit>
+static int setCube(struct solver<Lit>* S, const int* cube, int size)
+{                                                                     // Decide the literals of the cube on top of the root
+    restart(S);                                                       // level; UNSAT if propagation refutes the cube
+    for (int i = 0; i < size; i++)
+    {
+        if (S->fals[cube[i]]) return UNSAT;
+        if (S->fals[-cube[i]]) continue;
+        int old_nConflicts = S->nConflicts;
+        decide(S, cube[i]);
+        int result = propagate(S);
+        if (result == ERROR) return ERROR;
+        if (result == UNSAT || S->nConflicts > old_nConflicts) return UNSAT;
+    }
+    return SAT;
+}
+
+template <typename Lit>
+static int lookahead(struct solver<Lit>* S, const int* cube, int size)
+{                                                                     // Pick the variable to split the cube on (0: none):
+    int cands[LOOKAHEAD_VARS], scores[LOOKAHEAD_VARS], nCands = 0;    // among the unassigned variables with most watches
+    for (int v = 1; v <= S->nVars; v++)                               // and implications, the one whose two branches
+    {                                                                 // propagate the largest product of assignments
+        if (S->fals[v] || S->fals[-v]) continue;
+        int score = S->watches[v].size + S->watches[-v].size + S->bins[v].size + S->bins[-v].size
+                  + S->irrBins[v].size + S->irrBins[-v].size, i = nCands;
+        if (nCands < LOOKAHEAD_VARS) nCands++;
+        else if (score <= scores[i-1]) continue;
+        else i--;
+        for (; i > 0 && scores[i-1] < score; i--)                     // Insert into the candidates, sorted by score
+            cands[i] = cands[i-1], scores[i] = scores[i-1];
+        cands[i] = v; scores[i] = score;
+    }
+    int best = 0;
+    long long bestScore = -1;
+    int* base = S->assigned;
+    for (int i = 0; i < nCands; i++)
+    {
+        int v = cands[i], pos = probe(S, v), neg = 0;
+        if (pos >= 0)
+        {
+            backtrack(S, base);
+            neg = probe(S, -v);
+        }
+        if (pos < 0 || neg < 0)
+        {                                                             // A failed literal: one branch is refuted at once
+            if (setCube(S, cube, size) == ERROR) return ERROR;
+            return v;
+        }
+        backtrack(S, base);
+        long long score = (long long) (pos + 1) * (neg + 1);
+        if (score > bestScore) best = v, bestScore = score;
+    }
+    return best;
+}
+
+struct cubeQueue
+{                                                                     // The cubes of one worker: the owner takes the newest,
+    pthread_mutex_t lock;                                             // thieves take the oldest (cubes[first] .. cubes[last-1])
+    int **cubes, first, last, cap;                                    // A cube is its size followed by its literals
+};
+
+static int appendCube(struct cubeQueue* Q, int* cube)
+{
+    pthread_mutex_lock (&Q->lock);
+    if (Q->last == Q->cap && Q->first > 0)
+    {                                                                 // Reuse the space of stolen cubes
+        memmove (Q->cubes, Q->cubes + Q->first, sizeof (int*) * (Q->last - Q->first));
+        Q->last -= Q->first; Q->first = 0;
+    }
+    if (Q->last == Q->cap)
+    {
+        int cap = Q->cap ? 2 * Q->cap : 64;
+        int** cubes = (int**) realloc (Q->cubes, sizeof (int*) * cap);
+        if (!cubes)
+        {
+            pthread_mutex_unlock (&Q->lock);
+            return ERROR;
+        }
+        Q->cubes = cubes; Q->cap = cap;
+    }
+    Q->cubes[Q->last++] = cube;
+    pthread_mutex_unlock (&Q->lock);
+    return SAT;
+}
+
+static int pushCube(struct cubeQueue* Q, const int* lits, int size)
+{                                                                     // Append a copy of the cube lits[0..size-1]
+    int* cube = (int*) malloc (sizeof (int) * (size + 1));
+    if (!cube) return ERROR;
+    cube[0] = size;
+    memcpy (cube + 1, lits, sizeof (int) * size);
+    if (appendCube(Q, cube) == SAT) return SAT;
+    free (cube);
+    return ERROR;
+}
+
+static int* takeCube(struct cubeQueue* Q, bool steal)
+{                                                                     // Remove a cube (NULL if the queue is empty)
+    int* cube = NULL;
+    pthread_mutex_lock (&Q->lock);
+    if (Q->first < Q->last)
+        cube = steal ? Q->cubes[Q->first++] : Q->cubes[--Q->last];
+    if (Q->first == Q->last) Q->first = Q->last = 0;
+    pthread_mutex_unlock (&Q->lock);
+    return cube;
+}
+
+template <typename Lit>
+static int makeCubes(struct solver<Lit>* S, int* cube, int size, int depth, struct cubeQueue* Q, int* nRefuted)
+{                                                                     // Split the cube by lookahead until depth is reached
+    int result = setCube(S, cube, size);
+    if (result == ERROR) return ERROR;
+    if (result == UNSAT)
+    {                                                                 // Refuted by the cuber: no need to conquer it
+        (*nRefuted)++;
+        return SAT;
+    }
+    int v = size < depth ? lookahead(S, cube, size) : 0;
+    if (v == ERROR) return ERROR;
+    if (!v) return pushCube(Q, cube, size);                           // A leaf (or every variable is assigned)
+    cube[size] = v;
+    if (makeCubes(S, cube, size + 1, depth, Q, nRefuted) == ERROR) return ERROR;
+    cube[size] = -v;
+    return makeCubes(S, cube, size + 1, depth, Q, nRefuted);
+}
+
+struct conquer
+{                                                                     // State shared by the cube-and-conquer workers
+    struct cubeQueue* queues;
+    int nWorkers, budget;                                             // Conflicts per cube before it is split again
+    std::atomic<int> stop, result, winner;
+    std::atomic<int> open;                                            // Cubes queued or being solved
+    std::atomic<int> nSplits;
+};
+
+template <typename Lit>
+struct cubeWorker
+{                                                                     // A conquer thread and its solver
+    struct solver<Lit>* S;
+    struct conquer* C;
+    pthread_t thread;
+    int id, nSolved;
+    bool running;
+};
+
+template <typename Lit>
+static void* runCubes(void* arg)
+{                                                                     // Solve cubes until all are refuted or one is satisfiable
+    struct cubeWorker<Lit>* w = (struct cubeWorker<Lit>*) arg;
+    struct conquer* C = w->C;
+    struct solver<Lit>* S = w->S;
+    while (!C->stop.load())
+    {
+        int* cube = takeCube(&C->queues[w->id], false);
+        for (int i = 1; !cube && i < C->nWorkers; i++)                // Steal the oldest cube of another worker,
+            cube = takeCube(&C->queues[(w->id + i) % C->nWorkers], true); // which is likely the largest subproblem
+        if (!cube)
+        {
+            if (!C->open.load()) break;                               // Every cube is refuted
+            sched_yield ();
+            continue;
+        }
+        restart(S);
+        int limit = S->conflictLimit;                                 // The budget of the whole solve
+        S->assumptions   = cube + 1;
+        S->nAssumptions  = cube[0];
+        S->conflictLimit = S->nConflicts < limit - C->budget ? S->nConflicts + C->budget : limit;
+        int result = solve(S);
+        S->nAssumptions  = 0;
+        S->conflictLimit = limit;
+        if (result == UNKNOWN && !C->stop.load() && outOfBudget(S, true))
+        {                                                             // Out of the budget of the whole solve (unless
+            free (cube);                                              // another worker found a model meanwhile)
+            int open = UNSAT;
+            if (C->result.compare_exchange_strong(open, UNKNOWN)) C->winner.store(w->id);
+            C->stop.store(1);
+            break;
+        }
+        if (result == UNKNOWN && !C->stop.load())
+        {                                                             // Out of the budget of the cube: split it in two
+            int v = setCube(S, cube + 1, cube[0]);
+            if (v == SAT) v = lookahead(S, cube + 1, cube[0]);
+            if (v == UNSAT) result = UNSAT;                           // Refuted while setting it up again
+            else if (v == ERROR) result = ERROR;
+            else
+            {
+                struct cubeQueue* Q = &C->queues[w->id];
+                int size = cube[0], *lits = S->buffer;                // The buffer is free between conflicts
+                memcpy (lits, cube + 1, sizeof (int) * size);
+                if (!v && pushCube(Q, lits, size) == ERROR)           // Every variable is assigned: retry as is
+                    result = ERROR;
+                else if (v)
+                {                                                     // One cube is replaced by two
+                    C->open++;
+                    lits[size] = v;
+                    if (pushCube(Q, lits, size + 1) == ERROR) result = ERROR;
+                    lits[size] = -v;
+                    if (pushCube(Q, lits, size + 1) == ERROR) result = ERROR;
+                    C->nSplits++;
+                }
+            }
+        }
+        free (cube);
+        if (result == UNSAT) w->nSolved++, C->open--;
+        else if (result == SAT || result == ERROR)
+        {                                                             // A model of the formula, or no memory left
+            C->result.store(result);
+            if (result == SAT) C->winner.store(w->id);
+            C->stop.store(1);
+        }
+    }
+    return NULL;
+}
+
+static void releaseQueues(struct cubeQueue* queues, int n)
+{                                                                     // Free the cubes left in the queues and their locks
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = queues[i].first; j < queues[i].last; j++)
+            free (queues[i].cubes[j]);
+        free (queues[i].cubes);
+        pthread_mutex_destroy (&queues[i].lock);
+    }
+}
+
+template <typename Lit>
+static int cubeError(struct cubeWorker<Lit>* workers, struct solver<Lit>* clones, struct cubeQueue* queues, int started)
+{                                                                     // Release everything solveCubes allocated, then fail
+    releaseQueues(queues, started);
+    for (int i = 1; i < started; i++)
+        freeCDCL(&clones[i]);
+    free (queues); free (workers); free (clones);
+    return ERROR;
+}
+
+template <typename Lit>
+int solveCubes(struct solver<Lit>* S, int nThreads, int depth, int budget, const char* cubeFile, struct solver<Lit>** won)
+{                                                                     // Cube-and-conquer: split the formula in S into cubes by
+    int result = propagate(S);                                        // lookahead, then solve them on nThreads workers; with a
+    if (result != SAT) return result;                                 // cube file, only write the cubes (UNKNOWN, or UNSAT
+    if (cubeFile) nThreads = 1;                                       // when lookahead refuted all of them)
+    struct cubeWorker<Lit>* workers = (struct cubeWorker<Lit>*) calloc (nThreads, sizeof (struct cubeWorker<Lit>));
+    struct solver<Lit>* clones = (struct solver<Lit>*) calloc (nThreads, sizeof (struct solver<Lit>));
+    struct cubeQueue* queues = (struct cubeQueue*) calloc (nThreads, sizeof (struct cubeQueue));
+    int* cube = (int*) calloc (depth + 1, sizeof (int));
+    if (!workers || !clones || !queues || !cube)
+    {
+        free (workers); free (clones); free (queues); free (cube);
+        return ERROR;
+    }
+    int started = 1;
+    for (; started < nThreads; started++)
+        if (cloneCDCL(&clones[started], S) == ERROR)
+        {                                                             // Clone before the cuber learns lemmas in S
+            freeCDCL(&clones[started]);
+            break;
+        }
+    for (int i = 0; i < started; i++)
+        pthread_mutex_init (&queues[i].lock, NULL);
+
+    double start = wallTime ();
+    int nRefuted = 0;
+    result = makeCubes(S, cube, 0, depth, &queues[0], &nRefuted);
+    restart(S);
+    free (cube);
+    if (result == ERROR) return cubeError(workers, clones, queues, started);
+    int nCubes = queues[0].last;
+    printf("c cuber: %i cubes of depth <= %i, %i refuted by lookahead, in %.2f s\n",
+           nCubes, depth, nRefuted, wallTime () - start);
+    if (!nCubes) printf("c cuber: lookahead refuted every cube\n");     // The formula is unsatisfiable
+    if (cubeFile)
+    {                                                                 // One "a <literals> 0" line per cube (iCNF style),
+        FILE* out = fopen (cubeFile, "w");                            // none if every cube was refuted
+        bool ok = out != NULL;
+        for (int i = 0; ok && i < nCubes; i++)
+        {
+            fputc ('a', out);
+            for (int j = 1; j <= queues[0].cubes[i][0]; j++)
+                fprintf (out, " %i", queues[0].cubes[i][j]);
+            fputs (" 0\n", out);
+        }
+        if (out && fclose (out)) ok = false;
+        if (!ok)
+        {
+            printf("c error: cannot write %s\n", cubeFile);
+            return cubeError(workers, clones, queues, started);
+        }
+        printf("c wrote %i cubes to %s\n", nCubes, cubeFile);
+        releaseQueues(queues, started);
+        free (queues); free (workers); free (clones);
+        return nCubes ? UNKNOWN : UNSAT;
+    }
+    int** cubes = queues[0].cubes;                                    // Deal the cubes out round-robin
+    queues[0].cubes = NULL; queues[0].last = queues[0].cap = 0;
+    for (int i = 0; i < nCubes; i++)
+        if (appendCube(&queues[i % started], cubes[i]) == ERROR)
+        {
+            for (int j = i; j < nCubes; j++)
+                free (cubes[j]);
+            free (cubes);
+            return cubeError(workers, clones, queues, started);
+        }
+    free (cubes);
+
+    struct conquer C;
+    C.queues = queues; C.nWorkers = started; C.budget = budget;
+    C.stop = 0; C.result = UNSAT; C.winner = 0; C.open = nCubes; C.nSplits = 0;
+    for (int i = 0; i < started; i++)
+    {
+        struct cubeWorker<Lit>* w = &workers[i];
+        w->S = i ? &clones[i] : S;
+        w->C = &C; w->id = i;
+        w->S->stop = &C.stop;
+    }
+    int running = 0;
+    for (int i = 0; i < started; i++)
+        if (!pthread_create (&workers[i].thread, NULL, runCubes<Lit>, &workers[i]))
+            workers[i].running = true, running++;
+    if (!running) runCubes<Lit>(&workers[0]);                         // Without threads, conquer inline
+    for (int i = 0; i < started; i++)
+        if (workers[i].running) pthread_join (workers[i].thread, NULL);
+
+    result = C.result.load();
+    int id = C.winner.load();
+    for (int i = 0; i < started; i++)
+        printf("c conquer: worker %i refuted %i cubes in %i conflicts\n", i, workers[i].nSolved, workers[i].S->nConflicts);
+    printf("c conquer: %i cubes, %i re-splits, %.2f s\n", nCubes, C.nSplits.load(), wallTime () - start);
+    releaseQueues(queues, started);                                   // The cubes left after a model was found
+    for (int i = 0; i < started; i++)
+        workers[i].S->stop = NULL;
+    for (int i = 1; i < started; i++)
+        if (i != id) freeCDCL(workers[i].S);                          // Keep only the solver with the answer alive
+    *won = workers[id].S;
+    if (!id) free (clones);                                           // (a winning clone stays allocated, like S)
+    free (queues); free (workers);
+    return result;
+}
+
+static int read_until_new_line (FILE * input)
+{
+    int ch;
+    while ((ch = getc (input)) != '\n')
+        if (ch == EOF)
+        {
+            printf ("c parse error: unexpected EOF\n");
+            return ERROR;
+        }
+    return SAT;
+}
+
+template <typename Lit>
+int parse_stdio (struct solver<Lit>* S, char* filename)
+{                                                                          // The original getc/fscanf parser, kept as a reference
+    int tmp;
+    FILE* input = fopen (filename, "r");                                   // Read the CNF file
+    if (!input)
+    {
+        printf ("c error: cannot open %s\n", filename);
+        return ERROR;
+    }
+    while ((tmp = getc (input)) == 'c')
+        if (read_until_new_line (input) == ERROR)
+        {
+            fclose (input);
+            return ERROR;
+        }
+    ungetc (tmp, input);
+    do
+    {
+        tmp = fscanf (input," p cnf %i %i \n", &S->nVars, &S->nClauses);   // Find the first non-comment line
+        if (tmp > 0 && tmp != EOF) 
+            break;
+        tmp = fscanf (input, "%*s\n");
+    } while (tmp != 2 && tmp != EOF);                                      // Skip it and read next line
+    if (initCDCL(S, S->nVars, S->nClauses) == ERROR)                       // Allocate the main datastructures
+    {
+        printf ("c out of memory\n");
+        fclose (input);
+        return ERROR;
+    }
+    int nZeros = S->nClauses, size = 0;                                    // Initialize the number of clauses to read
+    while (nZeros > 0)
+    {                                                                      // While there are clauses in the file
+        int ch = getc (input);
+        if (ch == ' ' || ch == '\n') continue;
+        if (ch == 'c')
+        {
+            if (read_until_new_line (input) == ERROR)
+            {
+                fclose (input);
+                return ERROR;
+            }
+            continue;
+        }
+        ungetc (ch, input);
+        int lit = 0;
         tmp = fscanf (input, " %i ", &lit);                                // Read a literal.
         if (!lit)
         {                                                                  // If reaching the end of the clause
-            int* clause = addClause(S, S->buffer, size, 1);                // Then add the clause to data_base
-            if (!size || ((size == 1) && S->fals[clause[0]]))              // Check for empty clause or conflicting unit
+            ref reason = addClause(S, S->buffer, size, 1, 0);              // Then add the clause to data_base
+            if (reason == ERROR)
+            {
+                printf ("c out of memory\n");
+                return ERROR;
+            }
+            if (!size || ((size == 1) && S->fals[S->buffer[0]]))           // Check for empty clause or conflicting unit
                 return UNSAT;                                              // If either is found return UNSAT
-            if ((size == 1) && !S->fals[-clause[0]])                       // Check for a new unit
-                assign (S, clause, 1);                                     // Directly assign new units (forced = 1)                
+            if ((size == 1) && !S->fals[-S->buffer[0]])                    // Check for a new unit
+                assign (S, S->buffer[0], reason, 1);                       // Directly assign new units (forced = 1)                
             size = 0;
             --nZeros;
         }                                                                  // Reset buffer
@@ -371,11 +3292,1024 @@ int parse (struct solver* S, char* filename)
     return SAT;                                                            // Return that no conflict was observed
 }
 
+struct input
+{                                                                          // A DIMACS file held in memory as one block
+    const char *data, *p, *end;                                            // The whole file, the scan position and its end
+    size_t size;
+    int mapped, line;                                                      // Whether data is mmapped; line number for errors
+    bool quiet;                                                            // No error messages (see narrowInput)
+};
+
+static int openInput (struct input* in, const char* filename)
+{                                                                          // Map a regular file, or read a stream in large blocks
+    in->data = NULL; in->size = 0; in->mapped = 0; in->line = 1; in->quiet = false;
+    int fd = strcmp (filename, "-") ? open (filename, O_RDONLY) : 0;       // "-" reads the formula from stdin
+    if (fd < 0)
+    {
+        printf ("c error: cannot open %s\n", filename);
+        return ERROR;
+    }
+    struct stat st;
+    if (!fstat (fd, &st) && S_ISREG (st.st_mode) && st.st_size > 0)
+    {                                                                      // Regular files are mapped without copying
+        void* map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            madvise (map, st.st_size, MADV_SEQUENTIAL);                    // The scanner reads the file front to back once
+            in->data = (const char*) map; in->size = st.st_size; in->mapped = 1;
+        }
+    }
+    if (!in->mapped)
+    {                                                                      // Pipes (or a failed mmap) are read in 1 MB+ blocks
+        size_t cap = 1 << 20;
+        char* buf = (char*) malloc (cap);
+        ssize_t n = 0;
+        while (buf && (n = read (fd, buf + in->size, cap - in->size)) > 0)
+            if ((in->size += n) == cap)
+                buf = (char*) realloc (buf, cap *= 2);                     // Grow the buffer geometrically
+        if (!buf || n < 0)
+        {
+            printf ("c error: cannot read %s\n", filename);
+            free (buf);
+            if (fd) close (fd);
+            return ERROR;
+        }
+        in->data = buf;
+    }
+    if (fd) close (fd);
+    in->p = in->data; in->end = in->data + in->size;
+    return SAT;
+}
+
+static void closeInput (struct input* in)
+{
+    if (in->mapped) munmap ((void*) in->data, in->size);
+    else free ((void*) in->data);
+}
+
+static int parseError (struct input* in, const char* msg)
+{
+    if (!in->quiet) printf ("c parse error: %s on line %i\n", msg, in->line);
+    return ERROR;
+}
+
+static int skipSpace (struct input* in)
+{                                                                          // Skip blanks and comment lines; return the next char
+    const char *p = in->p, *end = in->end;
+    while (p < end)
+    {
+        char ch = *p;
+        if (ch == 'c')
+        {                                                                  // A comment runs until the end of the line
+            p = (const char*) memchr (p, '\n', end - p);
+            if (!p) p = end;
+            continue;
+        }
+        if (ch == '\n') in->line++;
+        else if (ch != ' ' && ch != '\t' && ch != '\r') break;
+        p++;
+    }
+    in->p = p;
+    return p < end ? (unsigned char) *p : EOF;
+}
+
+static int readInt (struct input* in, int* value)
+{                                                                          // Decode a (signed) decimal integer at the scan position
+    const char *p = in->p, *end = in->end;
+    int sign = 1;
+    if (p < end && *p == '-') sign = -1, p++;
+    if (p == end || (unsigned) (*p - '0') > 9)
+        return parseError (in, "expected an integer");
+    long long v = 0;
+    do
+    {
+        v = v * 10 + (*p++ - '0');
+        if (v > INT_MAX) return parseError (in, "integer out of range");
+    } while (p < end && (unsigned) (*p - '0') <= 9);
+    if (p < end && *p != ' ' && *p != '\n' && *p != '\t' && *p != '\r')
+        return parseError (in, "unexpected character after integer");
+    in->p = p;
+    *value = (int) (sign * v);
+    return SAT;
+}
+
+template <typename Lit>
+static int readClauses (struct solver<Lit>* S, struct input* in, signed char* sign)
+{                                                                          // Read the clauses after the header; repeated literals
+    int nZeros = S->nClauses, size = 0, lit;                               // are dropped and tautologies skipped, so a clause
+    bool tautology = false;                                                // never has more literals than variables
+    while (nZeros > 0)
+    {                                                                      // While there are clauses in the file
+        if (skipSpace (in) == EOF)
+            return parseError (in, "unexpected end of file");
+        if (readInt (in, &lit) == ERROR) return ERROR;                     // Read a literal
+        if (!lit)
+        {                                                                  // If reaching the end of the clause
+            for (int i = 0; i < size; i++) sign[abs (S->buffer[i])] = 0;
+            --nZeros;
+            if (tautology)
+            {                                                              // Satisfied by every assignment
+                tautology = false;
+                size = 0;
+                continue;
+            }
+            ref reason = addClause(S, S->buffer, size, 1, 0);              // Then add the clause to data_base
+            if (reason == ERROR)
+            {
+                printf ("c out of memory\n");
+                return ERROR;
+            }
+            if (!size || ((size == 1) && S->fals[S->buffer[0]]))           // Check for empty clause or conflicting unit
+                return UNSAT;                                              // If either is found return UNSAT
+            if ((size == 1) && !S->fals[-S->buffer[0]])                    // Check for a new unit
+                assign (S, S->buffer[0], reason, 1);                       // Directly assign new units (forced = 1)
+            size = 0;
+        }                                                                  // Reset buffer
+        else if (abs (lit) > S->nVars)
+            return parseError (in, "literal exceeds the number of variables");
+        else if (!sign[abs (lit)])
+        {                                                                  // Add literal to buffer
+            sign[abs (lit)] = lit > 0 ? 1 : -1;
+            S->buffer[size++] = lit;
+        }
+        else if (sign[abs (lit)] != (lit > 0 ? 1 : -1)) tautology = true;  // Both signs (a repeated literal is dropped)
+    }
+    return SAT;                                                            // Return that no conflict was observed
+}
+
+static int readHeader (struct input* in, int* nVars, int* nClauses)
+{                                                                          // Read the 'p cnf' line
+    if (skipSpace (in) != 'p') return parseError (in, "expected 'p cnf' header");
+    do in->p++; while (in->p < in->end && (*in->p == ' ' || *in->p == '\t'));
+    if (in->end - in->p < 3 || strncmp (in->p, "cnf", 3))
+        return parseError (in, "expected 'p cnf' header");
+    in->p += 3;
+    if (skipSpace (in) == EOF || readInt (in, nVars) == ERROR ||
+        skipSpace (in) == EOF || readInt (in, nClauses) == ERROR)
+        return ERROR;
+    if (*nVars < 0 || *nClauses < 0) return parseError (in, "negative count in header");
+    return SAT;
+}
+
+template <typename Lit>
+static int parseDIMACS (struct solver<Lit>* S, struct input* in, struct arena* A)
+{
+    int nVars, nClauses;
+    if (readHeader (in, &nVars, &nClauses) == ERROR) return ERROR;
+    if (nVars > MAX_VAR<Lit>) return parseError (in, "too many variables for 16-bit literals");
+    if (initCDCL(S, nVars, nClauses) == ERROR)                             // Allocate the main datastructures
+    {
+        printf ("c out of memory\n");
+        return ERROR;
+    }
+    adoptArena(S, A);                                                      // (a batch worker reuses its DB)
+    signed char* sign = (signed char*) calloc (S->nVars + 1, 1);           // Sign of each variable in the current clause
+    if (!sign)
+    {
+        printf ("c out of memory\n");
+        return ERROR;
+    }
+    int result = readClauses (S, in, sign);
+    free (sign);
+    return result;
+}
+
+enum { CACHE_VERSION = 3, CACHE_PATH_MAX = 4096 };
+static const char CACHE_MAGIC[8] = { 'm', 's', 'a', 't', 'b', 'i', 'n', '\n' };
+enum { CACHE_DB, CACHE_NWATCHES, CACHE_WATCHES, CACHE_NBINS, CACHE_BINS, CACHE_UNITS, CACHE_REASONS, CACHE_SECTIONS };
+
+struct cacheHeader
+{                                                                          // Header of a binary CNF cache (native byte order), then
+    char magic[8];                                                         // the path of its CNF (sourceSize bytes with the 0) and the
+    int version, watchSize, litSize, nVars, nClauses, nUnits, sourceSize;  // sections in the order above, each padded to 8 bytes: DB
+    long long memFixed, nWatches, nBinLits;                                // to mem_fixed, the watches per literal (-nVars..nVars) and
+    unsigned long long checksum;                                           // the watches, likewise the implied literals, the root
+};                                                                         // units and their reasons
+
+static unsigned long long checksum (const void* data, size_t bytes, unsigned long long h)
+{                                                                          // Hash a section in four independent lanes
+    const unsigned long long* w = (const unsigned long long*) data;
+    unsigned long long lane[4] = { h, h ^ 1, h ^ 2, h ^ 3 }, tail = 0;
+    size_t n = bytes / 8, i = 0;
+    for (; i + 4 <= n; i += 4)
+        for (int k = 0; k < 4; k++)
+        {
+            lane[k] = (lane[k] ^ w[i + k]) * 0x9E3779B97F4A7C15ull;
+            lane[k] ^= lane[k] >> 29;
+        }
+    for (; i < n; i++) lane[0] = (lane[0] ^ w[i]) * 0x9E3779B97F4A7C15ull;
+    memcpy (&tail, w + n, bytes % 8);                                      // The padding counts as zeros
+    lane[1] = (lane[1] ^ tail ^ bytes) * 0xBF58476D1CE4E5B9ull;
+    return ((lane[0] * 31 + lane[1]) * 31 + lane[2]) * 31 + lane[3];
+}
+
+static size_t padded (size_t bytes) { return (bytes + 7) & ~(size_t) 7; }
+
+static void cacheSizes (const struct cacheHeader* h, size_t* bytes)
+{                                                                          // The size of each section
+    bytes[CACHE_DB]       = (size_t) h->litSize * (size_t) h->memFixed;
+    bytes[CACHE_NWATCHES] = bytes[CACHE_NBINS] = sizeof (int) * (2 * (size_t) h->nVars + 1);
+    bytes[CACHE_WATCHES]  = sizeof (struct watch) * (size_t) h->nWatches;
+    bytes[CACHE_BINS]     = sizeof (int) * (size_t) h->nBinLits;
+    bytes[CACHE_UNITS]    = sizeof (int) * (size_t) h->nUnits;
+    bytes[CACHE_REASONS] = sizeof (long long) * (size_t) h->nUnits;
+}
+
+#ifndef MICROSAT_LIBRARY
+template <typename Lit>
+static int writeCache (struct solver<Lit>* S, const char* path, const char* filename)
+{                                                                          // Write the parsed formula as a binary cache
+    int n = S->nVars, nUnits = (int) (S->assigned - S->falseStack);
+    struct cacheHeader h;
+    memset (&h, 0, sizeof (h));
+    memcpy (h.magic, CACHE_MAGIC, sizeof (h.magic));
+    h.version = CACHE_VERSION; h.watchSize = sizeof (struct watch); h.litSize = sizeof (Lit);
+    char* source = strcmp (filename, "-") ? realpath (filename, NULL) : NULL;
+    if (source && strlen (source) < CACHE_PATH_MAX) h.sourceSize = (int) strlen (source) + 1;
+    h.nVars = n; h.nClauses = S->nClauses; h.nUnits = nUnits; h.memFixed = S->mem_fixed;
+    for (int lit = -n; lit <= n; lit++)
+    {
+        h.nWatches += S->watches[lit].size;
+        h.nBinLits += S->irrBins[lit].size;
+    }
+    size_t bytes[CACHE_SECTIONS];
+    cacheSizes (&h, bytes);
+    int *nWatches = (int*) malloc (bytes[CACHE_NWATCHES]), *nBins = (int*) malloc (bytes[CACHE_NBINS]);
+    struct watch* watches = (struct watch*) malloc (bytes[CACHE_WATCHES] + 1);
+    int *bins = (int*) malloc (bytes[CACHE_BINS] + 1), *units = (int*) malloc (bytes[CACHE_UNITS] + 1);
+    long long* reasons = (long long*) malloc (bytes[CACHE_REASONS] + 1);
+    bool ok = nWatches && nBins && watches && bins && units && reasons;
+    for (long long lit = -n, w = 0, b = 0; ok && lit <= n; lit++)
+    {                                                                      // Concatenate the per-literal arrays
+        const struct watchList* ws = &S->watches[lit];
+        const struct binList* bs = &S->irrBins[lit];
+        memcpy (watches + w, ws->w, sizeof (struct watch) * ws->size);
+        memcpy (bins + b, bs->lits, sizeof (int) * bs->size);
+        w += nWatches[n + lit] = ws->size;
+        b += nBins[n + lit] = bs->size;
+    }
+    for (int i = 0; ok && i < nUnits; i++)
+    {                                                                      // Root units as true literals
+        units[i] = -S->falseStack[i];
+        reasons[i] = S->reason[abs(units[i])];
+    }
+    const void* data[CACHE_SECTIONS] = { S->DB, nWatches, watches, nBins, bins, units, reasons };
+    h.checksum = CACHE_VERSION;
+    for (int i = 0; ok && i < CACHE_SECTIONS; i++) h.checksum = checksum (data[i], bytes[i], h.checksum);
+    FILE* out = ok ? fopen (path, "wb") : NULL;
+    static const char zeros[8] = { 0 };
+    ok = out && fwrite (&h, sizeof (h), 1, out) == 1 && fwrite (source, 1, h.sourceSize, out) == (size_t) h.sourceSize &&
+         fwrite (zeros, 1, padded (h.sourceSize) - h.sourceSize, out) == padded (h.sourceSize) - h.sourceSize;
+    for (int i = 0; ok && i < CACHE_SECTIONS; i++)
+        ok = fwrite (data[i], 1, bytes[i], out) == bytes[i] &&
+             fwrite (zeros, 1, padded (bytes[i]) - bytes[i], out) == padded (bytes[i]) - bytes[i];
+    if (out && fclose (out)) ok = false;
+    free (nWatches); free (watches); free (nBins); free (bins); free (units); free (reasons); free (source);
+    return ok ? SAT : ERROR;
+}
+#endif
+
+static int cacheError (const char* msg)
+{
+    printf ("c error: %s\n", msg);
+    return ERROR;
+}
+
+static const char* cacheSource (const struct cacheHeader* h, const struct input* in)
+{                                                                          // The CNF the cache was written from, or NULL
+    size_t size = h->sourceSize;
+    if (h->sourceSize < 2 || h->sourceSize > CACHE_PATH_MAX || sizeof (*h) + size > in->size) return NULL;
+    const char* path = in->data + sizeof (*h);
+    return path[size - 1] || strlen (path) != size - 1 ? NULL : path;
+}
+
+static unsigned long long watchKey (long long cref, int lit)
+{                                                                          // Mix a watch into 64 bits (splitmix64)
+    unsigned long long x = (unsigned long long) cref * 0x9E3779B97F4A7C15ull ^ (unsigned) lit;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+template <typename Lit>
+static const char* checkSections (const struct cacheHeader* h, const char* const* data, unsigned long long* start)
+{                                                                          // Check every literal, count and offset of the sections
+    int n = h->nVars;                                                      // (start: zeroed bits, one per entry of the DB section)
+    ref end = (ref) h->memFixed, c = 1 + HEAD<Lit>;
+    const Lit* DB = (const Lit*) data[CACHE_DB];
+    unsigned long long clauseKeys = 0, watchKeys = 0;
+    while (c < end)
+    {                                                                      // Walk the clauses: [lbd, stamp, literals..., 0]
+        ref first = c;
+        for (; c < end && DB[c]; c++)
+            if (DB[c] < -n || DB[c] > n) return "clause literal out of range";
+        if (c == end || c == first) return "clause runs past the database or is empty";
+        start[first >> 6] |= 1ull << (first & 63);
+        if (c - first > 1) clauseKeys += watchKey (first, DB[first]) + watchKey (first, DB[first + 1]);
+        c += 1 + HEAD<Lit>;                                                // Skip the 0 and the header of the next clause
+    }
+    if (c != end + HEAD<Lit>) return "database ends inside a clause";
+    const int* count = (const int*) data[CACHE_NWATCHES] + n;
+    const struct watch* w = (const struct watch*) data[CACHE_WATCHES];
+    long long total = 0;
+    for (int lit = -n; lit <= n; total += count[lit++])
+    {                                                                      // Each watch on a clause start, with a valid blocker
+        if (count[lit] < 0 || count[lit] > h->nWatches - total) return "watch counts exceed the watches";
+        for (const struct watch *e = w + total, *last = e + count[lit]; e < last; e++)
+        {
+            if (e->cref < 1 + HEAD<Lit> || e->cref >= end || !(start[e->cref >> 6] >> (e->cref & 63) & 1) ||
+                !e->blocker || e->blocker < -n || e->blocker > n)
+                return "watch out of range";
+            watchKeys += watchKey (e->cref, lit);
+        }
+    }
+    if (total != h->nWatches) return "watch counts do not add up";
+    if (watchKeys != clauseKeys)                                           // and the watches are those of the first two literals of
+        return "watches do not match the clauses";                         // each clause (as multisets, without random DB reads)
+    count = (const int*) data[CACHE_NBINS] + n;
+    const int* bins = (const int*) data[CACHE_BINS];
+    total = 0;
+    for (int lit = -n; lit <= n; total += count[lit++])
+    {
+        if (count[lit] < 0 || count[lit] > h->nBinLits - total) return "implication counts exceed the implications";
+        for (long long i = total; i < total + count[lit]; i++)
+            if (!bins[i] || bins[i] < -n || bins[i] > n) return "implied literal out of range";
+    }
+    if (total != h->nBinLits) return "implication counts do not add up";
+    const int* units = (const int*) data[CACHE_UNITS];
+    const long long* reasons = (const long long*) data[CACHE_REASONS];
+    unsigned char* assigned = (unsigned char*) calloc (n + 1, 1);
+    const char* problem = assigned ? NULL : "out of memory";
+    for (int i = 0; !problem && i < h->nUnits; i++)
+    {                                                                      // Each unit once, with its unit clause as the reason
+        int lit = units[i];
+        long long r = reasons[i];
+        if (!lit || lit < -n || lit > n || assigned[abs (lit)]++) problem = "root unit out of range or repeated";
+        else if (r < 1 + HEAD<Lit> || r >= end || !(start[r >> 6] >> (r & 63) & 1) || DB[r] != lit || DB[r + 1])
+            problem = "reason of a root unit out of range";
+    }
+    free (assigned);
+    return problem;
+}
+
+static const char* checkCache (const struct cacheHeader* h, const struct input* in, const char** data)
+{                                                                          // Locate and check the sections: NULL if the cache is sound
+    if (h->version != CACHE_VERSION || h->watchSize != (int) sizeof (struct watch) ||
+        (h->litSize != (int) sizeof (short) && h->litSize != (int) sizeof (int)))
+        return "written by another version or build";                      // (the watch layout differs with and without DB64)
+    if (h->litSize < (int) sizeof (int) && h->nVars > MAX_VAR<short>) return "header is corrupt";
+    if (h->nVars < 1 || h->nClauses < 0 || h->nUnits < 0 || h->nUnits > h->nVars || h->memFixed < 1 || h->memFixed > REF_MAX ||
+        (size_t) h->memFixed > in->size || h->nWatches < 0 || (size_t) h->nWatches > in->size ||
+        h->nBinLits < 0 || (size_t) h->nBinLits > in->size || h->sourceSize < 0 || h->sourceSize > CACHE_PATH_MAX)
+        return "header is corrupt";                                        // (bounded counts keep the offsets from overflowing)
+    size_t bytes[CACHE_SECTIONS], offset = sizeof (*h) + padded (h->sourceSize);
+    cacheSizes (h, bytes);
+    for (int i = 0; i < CACHE_SECTIONS; i++)
+    {
+        data[i] = in->data + offset;
+        offset += padded (bytes[i]);
+    }
+    if (offset > in->size) return "truncated";
+    unsigned long long sum = CACHE_VERSION;
+    for (int i = 0; i < CACHE_SECTIONS; i++) sum = checksum (data[i], bytes[i], sum);
+    if (sum != h->checksum) return "checksum mismatch";
+    unsigned long long* start = (unsigned long long*) calloc ((size_t) h->memFixed / 64 + 1, 8);
+    const char* problem = !start ? "out of memory" : h->litSize < (int) sizeof (int) ? checkSections<short> (h, data, start)
+                                                                                     : checkSections<int> (h, data, start);
+    free (start);
+    return problem;
+}
+
+template <typename Lit>
+static int loadCache (struct solver<Lit>* S, struct input* in, const char* const* data, struct arena* A)
+{                                                                          // Set up S from a cache checked by openFormula: every
+    struct cacheHeader h;                                                  // array is copied as a whole, only the units are
+    memcpy (&h, in->data, sizeof (h));                                     // assigned one by one
+    if (h.litSize != (int) sizeof (Lit)) return cacheError ("cache written with literals of another width");
+    if (initCDCL(S, h.nVars, h.nClauses) == ERROR) return cacheError ("out of memory");
+    adoptArena(S, A);
+    Lit* DB = getMemory (S, (ref) h.memFixed - S->mem_used);               // DB already holds its leading 0
+    if (!DB) return cacheError ("out of memory");
+    memcpy (DB, data[CACHE_DB] + sizeof (Lit), sizeof (Lit) * ((size_t) h.memFixed - 1));
+    S->mem_fixed = S->mem_used;
+    const int *nWatches = (const int*) data[CACHE_NWATCHES] + h.nVars, *nBins = (const int*) data[CACHE_NBINS] + h.nVars;
+    const struct watch* watches = (const struct watch*) data[CACHE_WATCHES];
+    const int* bins = (const int*) data[CACHE_BINS];
+    for (int lit = -h.nVars; lit <= h.nVars; watches += nWatches[lit], bins += nBins[lit++])
+    {                                                                      // Each list is allocated at its final size
+        struct watchList* ws = &S->watches[lit];
+        struct binList* bs = &S->irrBins[lit];
+        if ((nWatches[lit] && !(ws->w = (struct watch*) malloc (sizeof (struct watch) * nWatches[lit]))) ||
+            (nBins[lit] && !(bs->lits = (int*) malloc (sizeof (int) * nBins[lit]))))
+            return cacheError ("out of memory");
+        memcpy (ws->w, watches, sizeof (struct watch) * nWatches[lit]);
+        memcpy (bs->lits, bins, sizeof (int) * nBins[lit]);
+        ws->size = ws->cap = nWatches[lit];
+        bs->size = bs->cap = nBins[lit];
+    }
+    const int* units = (const int*) data[CACHE_UNITS];
+    const long long* reasons = (const long long*) data[CACHE_REASONS];
+    for (int i = 0; i < h.nUnits; i++)
+        assign (S, units[i], (ref) reasons[i], 1);                         // Root units, as the parser assigned them
+    return SAT;
+}
+
+static int openFormula (struct input* in, const char* filename, const char** data)
+{                                                                          // Map (or read) the formula; a cache is checked and its
+    if (openInput (in, filename) == ERROR) return ERROR;                   // sections located in data (data[CACHE_DB] is NULL for
+    data[CACHE_DB] = NULL;                                                 // a CNF), and one that fails the checks is replaced by
+    if (in->size < sizeof (struct cacheHeader) || memcmp (in->data, CACHE_MAGIC, sizeof (CACHE_MAGIC)))
+        return SAT;                                                        // the CNF it was written from
+    struct cacheHeader h;
+    memcpy (&h, in->data, sizeof (h));
+    const char* problem = checkCache (&h, in, data);
+    if (!problem) return SAT;
+    data[CACHE_DB] = NULL;
+    const char* source = h.version == CACHE_VERSION ? cacheSource (&h, in) : NULL;
+    if (!source)
+    {
+        printf ("c error: cache %s (rewrite it with --write-cache)\n", problem);
+        closeInput (in);
+        return ERROR;
+    }
+    printf ("c cache %s, parsing %s instead\n", problem, source);
+    char* path = strdup (source);                                          // (the path lies in the cache, closed first)
+    closeInput (in);
+    if (!path) return cacheError ("out of memory");
+    int result = openInput (in, path);
+    free (path);
+    return result;
+}
+
+template <typename Lit>
+static int parseInput (struct solver<Lit>* S, struct input* in, const char* const* data, struct arena* A)
+{                                                                          // Initialize S from an open formula
+    return data[CACHE_DB] ? loadCache (S, in, data, A) : parseDIMACS (S, in, A);
+}
+
+template <typename Lit>
+int parse (struct solver<Lit>* S, char* filename)
+{                                                                          // Parse the formula (or load its cache) and initialize
+    struct input in;
+    const char* data[CACHE_SECTIONS];
+    if (openFormula (&in, filename, data) == ERROR) return ERROR;          // Map (or read) the formula file
+    int result = parseInput (S, &in, data, NULL);
+    closeInput (&in);                                                      // Unmap the formula file
+    return result;                                                         // SAT: no conflict observed, UNSAT or ERROR
+}
+
+#ifdef MICROSAT_LIBRARY                                                    // The library offers the entry points of the int
+template int parse (struct solver<int>*, char*);                           // solver, as the Solver class does
+template int parse_stdio (struct solver<int>*, char*);
+template int preprocess (struct solver<int>*, struct preprocessor*);
+template int enumerate (struct solver<int>*, const int*, int, long long, long long*, FILE*);
+template int solvePortfolio (struct solver<int>*, int, int, int, struct solver<int>**);
+template int solveCubes (struct solver<int>*, int, int, int, const char*, struct solver<int>**);
+#else                                                                      // The command line front end from here on: define
+                                                                           // MICROSAT_LIBRARY before including this file to use the
+                                                                           // Solver class without it (or the helpers only it calls)
+#ifdef STATS
+static void writeHistogram(FILE* out, const char* name, const long long* hist)
+{
+    fprintf (out, ",\n  \"%s\": [", name);
+    for (int i = 0; i < HIST_SIZE; i++)
+        fprintf (out, "%s%lld", i ? ", " : "", hist[i]);
+    fprintf (out, "]");
+}
+#endif
+
+template <typename Lit>
+static int writeStats(const char* path, struct solver<Lit>* S, const char* filename, int result, double time)
+{                                                                     // Dump the final statistics as one JSON object
+    FILE* out = strcmp (path, "-") ? fopen (path, "w") : stdout;
+    if (!out) return ERROR;
+    const char* answer = result == SAT ? "SATISFIABLE" : result == UNSAT ? "UNSATISFIABLE" : "UNKNOWN";
+    fprintf (out, "{\n  \"file\": \"");
+    for (const char* c = filename; *c; c++)                            // Escape the file name as a JSON string
+        if (*c == '"' || *c == '\\') fprintf (out, "\\%c", *c);
+        else if ((unsigned char) *c < 0x20) fprintf (out, "\\u%04x", *c);
+        else fputc (*c, out);
+    fprintf (out, "\",\n  \"result\": \"%s\",\n  \"time\": %.6f,\n  \"vars\": %i,\n  \"clauses\": %i,\n"
+             "  \"mem\": %lld,\n  \"conflicts\": %i,\n  \"propagations\": %lld,\n  \"lemmas\": %i,\n  \"max_lemmas\": %i,\n"
+             "  \"reuses\": %i,\n  \"reused_literals\": %lld,\n  \"chrono_backtracks\": %i,\n  \"chrono_literals\": %lld,\n"
+             "  \"walks\": %i,\n  \"walk_flips\": %lld,\n  \"walk_best\": %i,\n"
+             "  \"vivify_rounds\": %i,\n  \"vivified\": %lld,\n  \"vivified_literals\": %lld,\n  \"vivify_time\": %.6f,\n"
+             "  \"restart_policy\": \"%s\",\n  \"restarts\": %i,\n  \"mode_switches\": %i,\n"
+             "  \"stable_restarts\": %i,\n  \"stable_conflicts\": %lld,\n  \"clause_scan\": \"%s\"",
+             answer, time, S->nVars, S->nClauses, (long long) S->mem_used, S->nConflicts, S->nPropagations,
+             S->nLemmas, S->maxLemmas, S->nReuses, S->reusedLits, S->nChrono, S->chronoLits,
+             S->nWalks, S->walkFlips, S->walkBest, S->nVivify, S->vivified, S->vivifiedLits, S->vivifyTime,
+             restartNames[S->schedule.policy], S->nRestarts, S->nSwitches, S->nStableRestarts, stableConflicts(S),
+             scanName<Lit>());
+#ifdef STATS
+    const struct stats* st = &S->stats;
+    fprintf (out, ",\n  \"decisions\": %lld,\n  \"watch_visits\": %lld,\n  \"clause_visits\": %lld,\n"
+             "  \"reductions\": %lld,\n  \"reduce_time\": %.6f,\n  \"minimized\": %lld",
+             st->decisions, st->watchVisits, st->clauseVisits, st->reductions, st->reduceTime, st->minimized);
+    writeHistogram (out, "lemma_size", st->lemmaSize);
+    writeHistogram (out, "lemma_lbd", st->lemmaLbd);
+#endif
+    fprintf (out, "\n}\n");
+    return out == stdout ? (fflush (out), SAT) : (fclose (out) ? ERROR : SAT);
+}
+
+static bool narrowInput (const struct input* in, const char* const* data)
+{                                                                          // Whether the formula takes 16-bit literals: a cache
+    if (data[CACHE_DB])                                                    // keeps the width it was written with, a CNF gets them
+    {                                                                      // if its header has at most MAX_VAR<short> variables
+        struct cacheHeader h;                                              // (a malformed header is left to the parser)
+        memcpy (&h, in->data, sizeof (h));
+        return h.litSize < (int) sizeof (int);
+    }
+    struct input header = *in;
+    header.quiet = true;
+    int nVars, nClauses;
+    return readHeader (&header, &nVars, &nClauses) == SAT && nVars <= MAX_VAR<short>;
+}
+
+struct budget
+{                                                                          // The limits of a command line solve (0: none)
+    int conflicts;
+    long long propagations;
+    long long mem;                                                         // Bytes of DB
+    double seconds;                                                        // Since the start, parsing included
+    std::atomic<int>* interrupt;
+};
+
+template <typename Lit>
+static void setBudget (struct solver<Lit>* S, const struct budget* b, double start)
+{
+    S->conflictLimit    = b->conflicts > 0 ? b->conflicts : INT_MAX;
+    S->propagationLimit = b->propagations > 0 ? b->propagations : LLONG_MAX;
+    long long mem       = (b->mem + sizeof (Lit) - 1) / sizeof (Lit);      // (entries of either width)
+    S->memLimit         = mem < REF_MAX ? (ref) mem : REF_MAX;
+    S->deadline         = b->seconds > 0 ? start + b->seconds : 0;
+    S->interrupt        = b->interrupt;
+}
+
+static std::atomic<int> interrupted (0);                                   // Set by SIGINT and SIGTERM
+
+static void onSignal (int)
+{
+    interrupted.store (1);                                                 // A second signal terminates as usual
+    signal (SIGINT, SIG_DFL);
+    signal (SIGTERM, SIG_DFL);
+}
+
+struct batchJob
+{                                                                          // One instance of a batch and its outcome
+    char* file;
+    int result, nConflicts;
+    double time;
+    bool done;
+};
+
+struct batch
+{                                                                          // State shared by the batch workers
+    struct batchJob* jobs;
+    int nJobs, printed;                                                    // Results are printed in input order
+    std::atomic<int> next;                                                 // The next job to take
+    pthread_mutex_t lock;                                                  // Guards done and printed
+    bool enabled[NPASSES], evsids, reuse, walk, vivify, wideLits;          // The options of every job
+    int chrono;
+    struct schedule schedule;
+    struct budget budget;                                                  // Per instance
+};
+
+static const char* resultName (int result)
+{
+    return result == SAT ? "SATISFIABLE" : result == UNSAT ? "UNSATISFIABLE" : result == UNKNOWN ? "UNKNOWN" : "ERROR";
+}
+
+static int batchFile (struct batchJob** jobs, int* nJobs, int* cap, const char* file)
+{                                                                          // Append a job for file
+    if (*nJobs == *cap)
+    {
+        int size = *cap ? 2 * *cap : 64;
+        struct batchJob* more = (struct batchJob*) realloc (*jobs, sizeof (struct batchJob) * size);
+        if (!more) return ERROR;
+        *jobs = more; *cap = size;
+    }
+    struct batchJob* job = &(*jobs)[*nJobs];
+    memset (job, 0, sizeof (*job));
+    if (!(job->file = strdup (file))) return ERROR;
+    (*nJobs)++;
+    return SAT;
+}
+
+static int compareJobs (const void* a, const void* b)
+{
+    return strcmp (((const struct batchJob*) a)->file, ((const struct batchJob*) b)->file);
+}
+
+static int readBatch (const char* list, struct batchJob** jobs, int* nJobs)
+{                                                                          // The regular files of a directory in name order, or
+    int cap = 0, result = SAT;                                             // the files named on the lines of a list ('#' lines
+    *jobs = NULL; *nJobs = 0;                                              // and blank lines are skipped)
+    DIR* dir = opendir (list);
+    if (dir)
+    {
+        char path[PATH_MAX];
+        for (struct dirent* e; result == SAT && (e = readdir (dir));)
+        {                                                                  // Skip hidden files, subdirectories and the like
+            struct stat st;
+            if (e->d_name[0] == '.' || snprintf (path, sizeof (path), "%s/%s", list, e->d_name) >= (int) sizeof (path))
+                continue;
+            if (!stat (path, &st) && S_ISREG (st.st_mode)) result = batchFile (jobs, nJobs, &cap, path);
+        }
+        closedir (dir);
+        if (result == SAT) qsort (*jobs, *nJobs, sizeof (struct batchJob), compareJobs);
+        return result;
+    }
+    FILE* in = fopen (list, "r");
+    if (!in) return ERROR;
+    char* line = NULL;
+    size_t size = 0;
+    for (ssize_t n; result == SAT && (n = getline (&line, &size, in)) >= 0;)
+    {
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r' || line[n - 1] == ' ' || line[n - 1] == '\t'))
+            line[--n] = 0;
+        if (n && line[0] != '#') result = batchFile (jobs, nJobs, &cap, line);
+    }
+    free (line);
+    fclose (in);
+    return result;
+}
+
+template <typename Lit>
+static int solveJob (struct batch* B, struct batchJob* job, struct input* in, const char** data, struct arena* A, double start)
+{                                                                          // Solve one instance on the DB of the worker (and close
+    struct solver<Lit> S;                                                  // its formula once parsed)
+    struct preprocessor P;
+    memset (&S, 0, sizeof (S));                                            // (freeing an empty solver is harmless)
+    memset (&P, 0, sizeof (P));
+    memcpy (P.enabled, B->enabled, sizeof (P.enabled));
+    P.quiet = true;
+    bool preprocessing = false;
+    for (int i = 0; i < NPASSES; i++) preprocessing |= P.enabled[i];
+    int result = parseInput (&S, in, data, A);
+    closeInput (in);
+    if (result == SAT && preprocessing) result = preprocess(&S, &P);
+    if (result == SAT)
+    {
+        S.evsids        = B->evsids;
+        S.reuse         = B->reuse;
+        S.chrono        = B->chrono;
+        S.walk          = B->walk;
+        S.vivify        = B->vivify;
+        S.schedule      = B->schedule;
+        setBudget (&S, &B->budget, start);
+        result = solve(&S);
+    }
+    job->nConflicts = S.nConflicts;
+    freePreprocessor(&P, true);
+    keepArena(&S, A);
+    return result;
+}
+
+static int solveFile (struct batch* B, struct batchJob* job, struct arena* A)
+{                                                                          // Open the formula of a job and solve it with the
+    if (B->budget.interrupt && B->budget.interrupt->load()) return UNKNOWN; // literal width it needs (skipping the rest of an
+    struct input in;                                                       // interrupted batch)
+    const char* data[CACHE_SECTIONS];
+    double start = wallTime ();
+    if (openFormula (&in, job->file, data) == ERROR) return ERROR;
+    return !B->wideLits && narrowInput (&in, data) ? solveJob<short> (B, job, &in, data, A, start)
+                                                   : solveJob<int> (B, job, &in, data, A, start);
+}
+
+static void* runBatch(void* arg)
+{                                                                          // Take jobs until none is left; whoever completes the
+    struct batch* B = (struct batch*) arg;                                 // next job in input order prints the completed prefix
+    struct arena A = { NULL, 0 };
+    for (int j; (j = B->next++) < B->nJobs;)
+    {
+        struct batchJob* job = &B->jobs[j];
+        double start = wallTime ();
+        job->result = solveFile(B, job, &A);
+        job->time = wallTime () - start;
+        pthread_mutex_lock (&B->lock);
+        job->done = true;
+        for (; B->printed < B->nJobs && B->jobs[B->printed].done; B->printed++)
+        {
+            struct batchJob* done = &B->jobs[B->printed];
+            printf("%s %s %.3f %i\n", done->file, resultName (done->result), done->time, done->nConflicts);
+        }
+        fflush (stdout);
+        pthread_mutex_unlock (&B->lock);
+    }
+    free (A.DB);
+    return NULL;
+}
+
+int solveBatch(struct batch* B, int nThreads)
+{                                                                          // Solve the jobs of B on a pool of nThreads workers
+    double start = wallTime ();
+    pthread_t* threads = (pthread_t*) calloc (nThreads, sizeof (pthread_t));
+    if (!threads) return ERROR;
+    pthread_mutex_init (&B->lock, NULL);
+    B->next = 0; B->printed = 0;
+    printf("c batch: %i instances on %i workers; FILE RESULT SECONDS CONFLICTS per line\n", B->nJobs, nThreads);
+    int started = 0;
+    while (started < nThreads && !pthread_create (&threads[started], NULL, runBatch, B)) started++;
+    if (!started) runBatch(B);                                             // Without threads, solve the jobs inline
+    for (int i = 0; i < started; i++) pthread_join (threads[i], NULL);
+    pthread_mutex_destroy (&B->lock);
+    free (threads);
+    int count[4] = { 0 };                                                  // UNKNOWN, ERROR, UNSAT and SAT (offset by 2)
+    for (int j = 0; j < B->nJobs; j++) count[B->jobs[j].result - UNKNOWN]++;
+    printf("c batch: %i satisfiable, %i unsatisfiable, %i unknown, %i errors in %.2f s\n",
+           count[SAT - UNKNOWN], count[UNSAT - UNKNOWN], count[0], count[ERROR - UNKNOWN], wallTime () - start);
+    return count[ERROR - UNKNOWN] ? ERROR : SAT;
+}
+
+struct options
+{                                                                          // The command line
+    int parseOnly, legacyParse, wideLits, nThreads, shareSize, shareLbd, evsids, reuse, chrono;
+    int walk, vivify, enumerating, cubeDepth, cubeBudget;
+    long long maxModels;
+    char *filename, *cubeFile, *jsonFile, *cacheFile, *batchList, *proofFile, *projection;
+    bool enabled[NPASSES];                                                 // The preprocessing passes
+    struct budget budget;
+    struct schedule schedule;
+    double progress;
+};
+
+template <typename Lit>
+static int run (const struct options* O, struct input* in, const char** data, double start)
+{                                                                          // Solve the formula of O with Lit literals and return
+    struct solver<Lit> S;	                                                   // the exit code (in is closed once parsed)
+    int result = O->legacyParse ? parse_stdio (&S, O->filename) : parseInput (&S, in, data, NULL);
+    if (!O->legacyParse) closeInput (in);                                  // Unmap the formula file
+    if (result == ERROR) return 1;                                         // Parse the DIMACS file
+    if (O->parseOnly)
+    {
+        double time = wallTime () - start, mb = 0;
+        struct stat st;
+        if (!stat (O->filename, &st)) mb = st.st_size / 1048576.0;
+        printf ("c parsed %s: %.1f MB, %i clauses in %.3f s (%.1f MB/s, %.0f clauses/s)\n",
+                O->filename, mb, S.nClauses, time, mb / time, S.nClauses / time);
+        return 0;
+    }
+    if (O->cacheFile)
+    {                                                                      // Later runs load OUT instead of parsing FILE
+        if (result == UNSAT)
+        {
+            printf ("s UNSATISFIABLE\n");                                   // (the parser stops at the first conflicting unit)
+            return 0;
+        }
+        if (writeCache (&S, O->cacheFile, O->filename) == ERROR)
+        {
+            printf ("c error: cannot write %s\n", O->cacheFile);
+            return 1;
+        }
+        printf ("c wrote %s: %lld %i-bit literals and headers, %i units in %.3f s\n",
+                O->cacheFile, (long long) S.mem_fixed, (int) (8 * sizeof (Lit)), (int) (S.assigned - S.falseStack), wallTime () - start);
+        return 0;
+    }
+    struct proof* proof = NULL;
+    if (O->proofFile && !(proof = S.proof = openProof (O->proofFile, S.nVars)))
+    {
+        printf ("c error: cannot write %s\n", O->proofFile);
+        return 1;
+    }
+    struct preprocessor P;
+    memset (&P, 0, sizeof (P));
+    memcpy (P.enabled, O->enabled, sizeof (P.enabled));
+    char* frozen = NULL;
+    int* project = NULL, nProject = 0;
+    if (O->enumerating)
+    {                                                                      // Preprocessing keeps the projection variables
+        frozen  = (char*) calloc (S.nVars + 1, 1);
+        project = (int*) malloc (sizeof (int) * S.nVars);
+        if (!frozen || !project) return 1;
+        nProject = O->projection ? readProjection (O->projection, S.nVars, frozen, project) : 0;
+        if (nProject == ERROR)
+        {
+            printf ("c error: bad projection %s (variables 1 to %i)\n", O->projection, S.nVars);
+            return 1;
+        }
+        for (int v = 1; !O->projection && v <= S.nVars; v++) frozen[v] = 1, project[nProject++] = v;
+        P.frozen = frozen;
+    }
+    bool preprocessing = false;
+    for (int i = 0; i < NPASSES; i++) preprocessing |= P.enabled[i];
+    if (result == SAT && preprocessing)                                    // Simplify the formula before search
+        result = preprocess(&S, &P);
+    S.evsids       = O->evsids;                                            // (preprocess rebuilds the solver)
+    S.reuse        = O->reuse;
+    S.chrono       = O->chrono > 0 ? O->chrono : 0;
+    S.walk         = O->walk;
+    S.vivify       = O->vivify;
+    S.schedule     = O->schedule;
+    S.progress     = O->progress;
+    S.startTime    = start;
+    S.nextProgress = start + O->progress;
+    setBudget (&S, &O->budget, start);                                     // (clones inherit the budget)
+    struct solver<Lit>* W = &S;                                            // The solver that found the answer
+    if (O->enumerating)
+    {                                                                      // All models (UNSAT), --max-models of them (SAT), or
+        long long nModels = 0;                                             // the ones found within the budget (UNKNOWN)
+        if (result == SAT) result = enumerate(&S, project, nProject, O->maxModels, &nModels, stdout);
+        double time = wallTime () - start;
+        printf("c enumerated %lld models%s in %.3f s (%.0f models/s)\n", nModels,
+               result == UNSAT ? "" : result == SAT ? ", stopped at --max-models" : ", incomplete", time, nModels / time);
+        if (nModels && result != ERROR) result = SAT;                      // The formula has a model
+        free (frozen); free (project);
+    }
+    else if (result == SAT && (O->cubeDepth > 0 || O->cubeFile))           // Split the formula into cubes and conquer them
+        result = solveCubes(&S, O->nThreads, O->cubeDepth > 0 ? O->cubeDepth : 1, O->cubeBudget > 0 ? O->cubeBudget : INT_MAX,
+                            O->cubeFile, &W);
+    else if (result == SAT)                                                // Solve within the budget, if any
+        result = O->nThreads > 1 ? solvePortfolio(&S, O->nThreads, O->shareSize, O->shareLbd, &W) : solve(&S);
+    if (proof)
+    {                                                                      // Derive the empty clause after an UNSAT answer
+        if (result == UNSAT) proofLine(proof, 'a', (const Lit*) NULL, 0);
+        printf("c proof: %lld clauses added, %lld deleted", proof->added, proof->deleted);
+        long long bytes = proof->bytes + proof->used;
+        if (closeProof(proof) == ERROR) printf(", cannot write %s\n", O->proofFile);
+        else printf(", %.1f MB written to %s\n", bytes / 1048576.0, O->proofFile);
+    }
+    if (result == ERROR)
+    {                                                                      // The clause database could not grow any further
+        printf("c out of memory\ns UNKNOWN\n");
+        return 1;
+    }
+    if (result == UNKNOWN && interrupted.load()) printf("c interrupted\n");
+    if (result == UNKNOWN) printf("s UNKNOWN\n");                         // Out of budget, or only the cubes were written
+    else if (result == UNSAT) printf("s UNSATISFIABLE\n");
+    else printf("s SATISFIABLE\n");                                        // And print whether the formula has a solution
+    if (result == SAT) extendModel(&P, W->model);                          // Values for the variables removed by preprocessing
+    freePreprocessor(&P, true);
+    printf("c statistics of %s: mem: %lld conflicts: %i max_lemmas: %i propagations: %lld\n",
+           O->filename, (long long) W->mem_used, W->nConflicts, W->maxLemmas, W->nPropagations);
+    printf("c trail: %i restarts kept %lld literals, %i chronological backtracks kept %lld\n",
+           W->nReuses, W->reusedLits, W->nChrono, W->chronoLits);
+    printf("c restarts: %i (%s)", W->nRestarts, restartNames[W->schedule.policy]);
+    if (W->schedule.modeInterval)
+        printf(", %i mode switches, %i restarts and %lld conflicts in stable mode",
+               W->nSwitches, W->nStableRestarts, stableConflicts(W));
+    printf("\n");
+    if (W->walk)
+        printf("c walk: %i local searches, %lld flips, %i clauses falsified by the last best assignment\n",
+               W->nWalks, W->walkFlips, W->walkBest);
+    if (W->vivify)
+        printf("c vivify: %i rounds shortened %lld lemmas by %lld literals in %.2f s\n",
+               W->nVivify, W->vivified, W->vivifiedLits, W->vivifyTime);
+    if (O->jsonFile && writeStats(O->jsonFile, W, O->filename, result, wallTime () - start) == ERROR)
+        printf("c could not write %s\n", O->jsonFile);
+    return 0;
+}
+
 int main(int argc, char** argv)
 {			                                                               // The main procedure for a STANDALONE solver
-    struct solver S;	                                                   // Create the solver datastructure
-    if (parse(&S, argv[1]) == UNSAT) printf("s UNSATISFIABLE\n");          // Parse the DIMACS file in argv[1]
-    else if (solve(&S) == UNSAT) printf("s UNSATISFIABLE\n");              // Solve without limit (number of conflicts)
-    else printf("s SATISFIABLE\n");                                        // And print whether the formula has a solution
-    printf("c statistics of %s: mem: %i conflicts: %i max_lemmas: %i\n", argv[1], S.mem_used, S.nConflicts, S.maxLemmas);
+    struct options O;
+    memset (&O, 0, sizeof (O));
+    O.nThreads = 1; O.shareSize = 8; O.shareLbd = 4; O.reuse = 1; O.cubeBudget = 10000;
+    O.budget.interrupt = &interrupted;
+    O.schedule = DEFAULT_SCHEDULE;
+    for (int i = 0; i < NPASSES; i++) O.enabled[i] = true;
+    for (int i = 1; i < argc; i++)
+    {                                                                      // Options precede the DIMACS file ("-" is stdin)
+        if      (!strcmp (argv[i], "--parse-only"))   O.parseOnly = 1;     // Stop after parsing and report throughput
+        else if (!strcmp (argv[i], "--legacy-parse")) O.legacyParse = 1;   // Use the getc/fscanf parser (for comparison)
+        else if (!strcmp (argv[i], "--wide-lits"))    O.wideLits = 1;      // 32-bit literals even where 16 bits do (likewise)
+        else if (!strcmp (argv[i], "--evsids"))       O.evsids = 1;        // Decide by activity instead of move-to-front
+        else if (!strcmp (argv[i], "--threads") && i + 1 < argc)          // Race N diversified solvers (portfolio)
+            O.nThreads = atoi (argv[++i]) > 1 ? atoi (argv[i]) : 1;
+        else if (!strcmp (argv[i], "--share-size") && i + 1 < argc)       // Longest lemma exchanged between threads (0: none)
+            O.shareSize = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--share-lbd") && i + 1 < argc)        // Highest LBD of an exchanged lemma
+            O.shareLbd = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--cube") && i + 1 < argc)             // Cube-and-conquer with cubes of this depth
+            O.cubeDepth = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--cube-budget") && i + 1 < argc)      // Conflicts on a cube before it is split again
+            O.cubeBudget = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--cube-file") && i + 1 < argc)        // Only write the cubes to this file
+            O.cubeFile = argv[++i];
+        else if (!strcmp (argv[i], "--progress") && i + 1 < argc)         // Print a progress line every SECONDS
+            O.progress = atof (argv[++i]);
+        else if (!strcmp (argv[i], "--json") && i + 1 < argc)             // Write the final statistics as JSON ("-": stdout)
+            O.jsonFile = argv[++i];
+        else if (!strcmp (argv[i], "--chrono") && i + 1 < argc)           // Backtrack chronologically when a backjump is longer
+            O.chrono = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--write-cache") && i + 1 < argc)      // Only convert FILE into a binary cache OUT
+            O.cacheFile = argv[++i];
+        else if (!strcmp (argv[i], "--batch") && i + 1 < argc)            // Solve the files of a directory or list on a pool
+            O.batchList = argv[++i];                                       // of --threads workers, one result line each
+        else if (!strcmp (argv[i], "--proof") && i + 1 < argc)            // Write a binary DRAT proof of an UNSAT answer
+            O.proofFile = argv[++i];
+        else if (!strcmp (argv[i], "--enumerate"))                         // Print every model, projected on --project (by
+            O.enumerating = 1;                                             // default on all variables)
+        else if (!strcmp (argv[i], "--project") && i + 1 < argc)          // Variables and ranges, such as 1-10,15
+            O.projection = argv[++i], O.enumerating = 1;
+        else if (!strcmp (argv[i], "--max-models") && i + 1 < argc)       // Stop enumerating after N models
+            O.maxModels = atoll (argv[++i]);
+        else if (!strcmp (argv[i], "--time-limit") && i + 1 < argc)       // Budgets per solver (per instance in a batch),
+            O.budget.seconds = atof (argv[++i]);                           // after which the answer is UNKNOWN
+        else if (!strcmp (argv[i], "--conflict-limit") && i + 1 < argc)
+            O.budget.conflicts = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--propagation-limit") && i + 1 < argc)
+            O.budget.propagations = atoll (argv[++i]);
+        else if (!strcmp (argv[i], "--memory-limit") && i + 1 < argc)     // Megabytes of clause database
+        {
+            double bytes = atof (argv[++i]) * 1048576.0;
+            O.budget.mem = bytes <= 0 ? 0 : bytes >= (double) LLONG_MAX ? LLONG_MAX : (long long) bytes;
+        }
+        else if (!strcmp (argv[i], "--walk"))                              // Local search sets the phases at restarts
+            O.walk = 1;
+        else if (!strcmp (argv[i], "--vivify"))                            // Shorten the useful lemmas at restarts
+            O.vivify = 1;
+        else if (!strcmp (argv[i], "--restart") && i + 1 < argc)          // Restart policy: ema, luby or geometric
+        {
+            const char* name = argv[++i];
+            O.schedule.policy = -1;
+            for (int j = 0; j < 3; j++)
+                if (!strcmp (name, restartNames[j])) O.schedule.policy = j;
+        }
+        else if (!strcmp (argv[i], "--restart-margin") && i + 1 < argc)   // EMA: fast over slow LBD average, in %
+            O.schedule.margin = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--restart-unit") && i + 1 < argc)     // Luby unit or first geometric interval
+            O.schedule.unit = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--restart-factor") && i + 1 < argc)   // Growth of the geometric interval
+            O.schedule.factor = atof (argv[++i]);
+        else if (!strcmp (argv[i], "--modes") && i + 1 < argc)            // Alternate focused and stable phases, the first
+            O.schedule.modeInterval = atoi (argv[++i]);                    // two of N conflicts (0: focused only)
+        else if (!strcmp (argv[i], "--stable-unit") && i + 1 < argc)      // Luby unit of stable mode
+            O.schedule.stableUnit = atoi (argv[++i]);
+        else if (!strcmp (argv[i], "--simd"))                              // Scan long clauses with vector kernels
+            scanClause<int> = pickScan<int>(), scanClause<short> = pickScan<short>();
+        else if (!strcmp (argv[i], "--no-reuse"))                          // Restart from the root level
+            O.reuse = 0;
+        else if (!strcmp (argv[i], "--no-pre"))                            // Search without preprocessing
+            for (int j = 0; j < NPASSES; j++) O.enabled[j] = false;
+        else if (!strncmp (argv[i], "--no-", 5))
+        {                                                                  // Disable one pass: --no-units, --no-equiv,
+            int j = 0;                                                     // --no-subsume, --no-elim or --no-probe
+            while (j < NPASSES && strcmp (argv[i] + 5, passNames[j])) j++;
+            if (j < NPASSES) O.enabled[j] = false;
+            else O.filename = argv[i];
+        }
+        else O.filename = argv[i];
+    }
+    signal (SIGINT, onSignal);                                             // Stop the search (and the batch) with UNKNOWN
+    signal (SIGTERM, onSignal);
+    if (O.schedule.policy < 0 || O.schedule.margin < 1 || O.schedule.unit < 1 || O.schedule.factor < 1 ||
+        O.schedule.modeInterval < 0 || O.schedule.stableUnit < 1)
+    {
+        printf ("c error: bad restart schedule (policy ema, luby or geometric, margin, units and factor at least 1)\n");
+        return 1;
+    }
+    if (O.batchList && (O.proofFile || O.enumerating))
+    {
+        printf ("c error: --%s needs a single FILE\n", O.proofFile ? "proof" : "enumerate");
+        return 1;
+    }
+    if (O.proofFile && O.enumerating)
+    {                                                                      // Blocking clauses do not follow from the formula
+        printf ("c error: --proof cannot cover the blocking clauses of --enumerate\n");
+        return 1;
+    }
+    if ((O.proofFile || O.enumerating) && (O.nThreads > 1 || O.cubeDepth > 0 || O.cubeFile))
+    {                                                                      // Lemmas of other workers and cubes are not RUP;
+        printf ("c --%s: solving on one thread without cubes\n", O.proofFile ? "proof" : "enumerate");
+        O.nThreads = 1; O.cubeDepth = 0; O.cubeFile = NULL;                // enumeration continues a single search
+    }
+    if (O.batchList)
+    {                                                                      // Each job solves its file on one thread
+        struct batch B;
+        if (readBatch (O.batchList, &B.jobs, &B.nJobs) == ERROR)
+        {
+            printf ("c error: cannot read %s\n", O.batchList);
+            return 1;
+        }
+        memcpy (B.enabled, O.enabled, sizeof (B.enabled));
+        B.evsids = O.evsids; B.reuse = O.reuse; B.walk = O.walk; B.vivify = O.vivify; B.chrono = O.chrono > 0 ? O.chrono : 0;
+        B.wideLits = O.wideLits;
+        B.schedule = O.schedule;
+        B.budget = O.budget;
+        int result = solveBatch (&B, O.nThreads);
+        for (int j = 0; j < B.nJobs; j++) free (B.jobs[j].file);
+        free (B.jobs);
+        return result == ERROR;
+    }
+    if (!O.filename)
+    {
+        printf ("c usage: %s [--parse-only] [--legacy-parse] [--wide-lits] [--write-cache OUT] [--evsids] [--threads N [--share-size N] [--share-lbd N]]\n"
+                "c        [--cube DEPTH [--cube-budget N] [--cube-file OUT]]\n"
+                "c        [--batch DIR|LIST] [--time-limit SECONDS] [--conflict-limit N] [--propagation-limit N]\n"
+                "c        [--memory-limit MB] [--proof OUT] [--enumerate [--project LIST] [--max-models N]]\n"
+                "c        [--restart ema|luby|geometric] [--restart-margin PERCENT] [--restart-unit N] [--restart-factor F]\n"
+                "c        [--modes N [--stable-unit N]]\n"
+                "c        [--no-reuse] [--chrono LEVELS] [--walk] [--vivify] [--simd] [--progress SECONDS] [--json OUT]\n"
+                "c        [--no-pre] [--no-units] [--no-equiv] [--no-subsume] [--no-elim] [--no-probe] FILE\n", argv[0]);
+        return 1;
+    }
+    double start = wallTime ();
+    if (O.legacyParse) return run<int> (&O, NULL, NULL, start);            // (its fscanf loop reads int literals)
+    struct input in;
+    const char* data[CACHE_SECTIONS];
+    if (openFormula (&in, O.filename, data) == ERROR) return 1;            // 16-bit literals where the formula allows them
+    return !O.wideLits && narrowInput (&in, data) ? run<short> (&O, &in, data, start) : run<int> (&O, &in, data, start);
 }
+#endif